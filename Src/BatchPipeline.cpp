@@ -0,0 +1,20 @@
+// *****************************************************************************
+// Source code for BatchPipeline module (worker decoding feeding the main thread)
+// *****************************************************************************
+
+#include "BatchPipeline.hpp"
+#include <algorithm>
+
+namespace BatchPipeline {
+
+	UInt32 GetWorkerCount (UInt32 itemCount)
+	{
+		// One core stays with the main thread, which writes to the database meanwhile
+		const UInt32 cores = std::thread::hardware_concurrency ();
+		if (cores < 2) {
+			return 0;
+		}
+		return std::min ({ cores - 1, MaxWorkers, itemCount / MinItemsPerWorker });
+	}
+
+} // namespace BatchPipeline
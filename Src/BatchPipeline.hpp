@@ -0,0 +1,130 @@
+// *****************************************************************************
+// Header file for BatchPipeline module (worker decoding feeding the main thread)
+// *****************************************************************************
+
+#ifndef BATCHPIPELINE_HPP
+#define BATCHPIPELINE_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Batch commands decode their items (ObjectState reads, validation, geometry)
+// before any database work. On big batches that CPU work runs on worker
+// threads while the main thread already creates the elements of the items
+// decoded so far: each worker decodes one contiguous slice of the items and
+// publishes how far it got in a per-slice counter; the main thread consumes
+// the slices in order and sleeps on a condition variable whenever it has
+// caught up with the worker of the current slice.
+//
+// Items are decoded in blocks of up to DecodeBlockSize so the geometry of a
+// block can go through PlacementKernel at once. decode(begin, end) must only
+// touch items [begin, end) and read-only inputs - no ACAPI calls.
+// consume(i) runs on the calling thread in index order, exactly as if the
+// batch were decoded inline; small batches are simply decoded inline.
+// consume returns false to stop the batch (e.g. cancelled in Archicad): no
+// later item is consumed, workers stop at their next block boundary and Run
+// returns once they have finished the block in hand.
+// -----------------------------------------------------------------------------
+
+namespace BatchPipeline {
+
+	constexpr UInt32	MinItemsPerWorker = 512;
+	constexpr UInt32	MaxWorkers = 8;
+	constexpr UInt32	DecodeBlockSize = 256;
+
+	// Number of worker threads worth starting for itemCount items (0 - decode inline)
+	UInt32 GetWorkerCount (UInt32 itemCount);
+
+	// Returns the number of items consumed - itemCount unless consume stopped the batch
+	template <typename Decode, typename Consume>
+	UInt32 Run (UInt32 itemCount, const Decode& decode, const Consume& consume)
+	{
+		const UInt32 workerCount = GetWorkerCount (itemCount);
+		if (workerCount == 0) {
+			for (UInt32 begin = 0; begin < itemCount; begin += DecodeBlockSize) {
+				const UInt32 end = std::min (begin + DecodeBlockSize, itemCount);
+				decode (begin, end);
+				for (UInt32 i = begin; i < end; ++i) {
+					if (!consume (i)) {
+						return i + 1;
+					}
+				}
+			}
+			return itemCount;
+		}
+
+		const UInt32 sliceSize = (itemCount + workerCount - 1) / workerCount;
+
+		// decodedEnd[w]: items of slice w below this index are decoded
+		std::unique_ptr<std::atomic<UInt32>[]> decodedEnd (new std::atomic<UInt32>[workerCount]);
+		for (UInt32 w = 0; w < workerCount; ++w) {
+			decodedEnd[w].store (w * sliceSize, std::memory_order_relaxed);
+		}
+		std::mutex progressMutex;
+		std::condition_variable progressChanged;
+		std::atomic<bool> stopped (false);		// set by the main thread only, so it never waits after setting it
+
+		std::vector<std::thread> workers;
+		for (UInt32 w = 0; w < workerCount; ++w) {
+			const UInt32 begin = w * sliceSize;
+			const UInt32 end = std::min (begin + sliceSize, itemCount);
+			std::atomic<UInt32>* progress = &decodedEnd[w];
+			workers.emplace_back ([&decode, &progressMutex, &progressChanged, &stopped, progress, begin, end] () {
+				for (UInt32 blockBegin = begin; blockBegin < end && !stopped.load (std::memory_order_relaxed); blockBegin += DecodeBlockSize) {
+					const UInt32 blockEnd = std::min (blockBegin + DecodeBlockSize, end);
+					decode (blockBegin, blockEnd);
+					{
+						// The release publishes the decoded items; the mutex keeps the wakeup from being lost
+						std::lock_guard<std::mutex> lock (progressMutex);
+						progress->store (blockEnd, std::memory_order_release);
+					}
+					progressChanged.notify_one ();
+				}
+			});
+		}
+
+		// Slices are consumed in order, so items reach the database in input order
+		UInt32 consumedCount = itemCount;
+		for (UInt32 w = 0; w < workerCount && !stopped.load (std::memory_order_relaxed); ++w) {
+			const UInt32 begin = w * sliceSize;
+			const UInt32 end = std::min (begin + sliceSize, itemCount);
+			UInt32 next = begin;
+			while (next < end) {
+				UInt32 available = decodedEnd[w].load (std::memory_order_acquire);
+				if (available == next) {
+					std::unique_lock<std::mutex> lock (progressMutex);
+					progressChanged.wait (lock, [&] () {
+						return decodedEnd[w].load (std::memory_order_acquire) > next;
+					});
+					available = decodedEnd[w].load (std::memory_order_acquire);
+				}
+				for (; next < available; ++next) {
+					if (!consume (next)) {
+						consumedCount = next + 1;
+						stopped.store (true, std::memory_order_relaxed);
+						break;
+					}
+				}
+				if (stopped.load (std::memory_order_relaxed)) {
+					break;
+				}
+			}
+		}
+
+		for (std::thread& worker : workers) {
+			worker.join ();
+		}
+		return consumedCount;
+	}
+
+} // namespace BatchPipeline
+
+#endif // BATCHPIPELINE_HPP
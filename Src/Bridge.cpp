@@ -4,38 +4,27 @@
 
 #include "Bridge.hpp"
 #include "DimensionHelper.hpp"
+#include "JsonReader.hpp"
 #include <cmath>
-#include <cstdlib>
+#include <cstring>
 
 // -----------------------------------------------------------------------------
-// Simple JSON parser helpers
+// JSON helpers on top of the single-pass JsonReader DOM
 // -----------------------------------------------------------------------------
 
 namespace {
-	// Extract string value from JSON (simple implementation)
-	GS::UniString ExtractJsonStringValue (const GS::UniString& json, const GS::UniString& key)
+	GS::UniString ToUniString (const std::string& utf8)
 	{
-		GS::UniString searchKey = "\"" + key + "\"";
-		Int32 keyPos = json.FindFirst (searchKey);
-		if (keyPos == MaxInt32)
-			return GS::EmptyUniString;
-
-		// Find colon after key
-		Int32 colonPos = json.FindFirst (":", keyPos);
-		if (colonPos == MaxInt32)
-			return GS::EmptyUniString;
-
-		// Find opening quote
-		Int32 quoteStart = json.FindFirst ("\"", colonPos);
-		if (quoteStart == MaxInt32)
-			return GS::EmptyUniString;
+		return GS::UniString (utf8.c_str (), CC_UTF8);
+	}
 
-		// Find closing quote
-		Int32 quoteEnd = json.FindFirst ("\"", quoteStart + 1);
-		if (quoteEnd == MaxInt32)
+	// Extract string value of a member
+	GS::UniString ExtractJsonStringValue (const JsonReader::Value& object, const char* key)
+	{
+		std::string value;
+		if (!object.Find (key).GetString (value))
 			return GS::EmptyUniString;
-
-		return json.GetSubstring (quoteStart + 1, quoteEnd);
+		return ToUniString (value);
 	}
 
 	// Create JSON response
@@ -61,132 +50,60 @@ namespace {
 	}
 
 	// Handle Ping command
-	GS::UniString HandlePingCommand (const GS::UniString& /*payload*/)
+	GS::UniString HandlePingCommand (const JsonReader::Value& /*payload*/)
 	{
 		GS::UniString result = "{\"message\":\"Dimension_Gh alive\"}";
 		return CreateJsonResponse (true, GS::EmptyUniString, result);
 	}
 
 	// Handle GetDimensions command (stub)
-	GS::UniString HandleGetDimensionsCommand (const GS::UniString& /*payload*/)
+	GS::UniString HandleGetDimensionsCommand (const JsonReader::Value& /*payload*/)
 	{
 		GS::UniString result = "{\"dimensions\":[]}";
 		return CreateJsonResponse (true, GS::EmptyUniString, result);
 	}
 
-	// Extract double value from JSON
-	double ExtractJsonDoubleValue (const GS::UniString& json, const GS::UniString& key)
+	// Extract double value of a member (0.0 if missing or not a number)
+	double ExtractJsonDoubleValue (const JsonReader::Value& object, const char* key)
 	{
-		GS::UniString searchKey = "\"" + key + "\"";
-		Int32 keyPos = json.FindFirst (searchKey);
-		if (keyPos == MaxInt32)
-			return 0.0;
-
-		// Find colon after key
-		Int32 colonPos = json.FindFirst (":", keyPos);
-		if (colonPos == MaxInt32)
+		double value = 0.0;
+		if (!object.Find (key).GetDouble (value))
 			return 0.0;
-
-		// Skip whitespace
-		Int32 valueStart = colonPos + 1;
-		USize jsonLength = json.GetLength ();
-		while (valueStart < (Int32)jsonLength && 
-			   (json[valueStart] == ' ' || json[valueStart] == '\t')) {
-			valueStart++;
-		}
-
-		// Find end of number (comma, closing brace, or bracket)
-		Int32 valueEnd = valueStart;
-		while (valueEnd < (Int32)jsonLength) {
-			char c = json[valueEnd];
-			if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t')
-				break;
-			valueEnd++;
-		}
-
-		if (valueEnd > valueStart) {
-			GS::UniString numStr = json.GetSubstring (valueStart, valueEnd);
-			// Convert UniString to double using std::atof
-			return std::atof (numStr.ToCStr ().Get ());
-		}
-
-		return 0.0;
+		return value;
 	}
 
 	// Extract point from JSON object (point1 or point2)
-	bool ExtractPointFromJson (const GS::UniString& json, const GS::UniString& pointKey, API_Coord& coord)
+	bool ExtractPointFromJson (const JsonReader::Value& object, const char* pointKey, API_Coord& coord)
 	{
-		// Find point object: "point1": { "x": ..., "y": ..., "z": ... }
-		GS::UniString searchKey = "\"" + pointKey + "\"";
-		Int32 keyPos = json.FindFirst (searchKey);
-		if (keyPos == MaxInt32)
+		// Point object: "point1": { "x": ..., "y": ..., "z": ... }
+		JsonReader::Value point = object.Find (pointKey);
+		if (!point.IsObject ())
 			return false;
 
-		// Find opening brace
-		Int32 braceStart = json.FindFirst ("{", keyPos);
-		if (braceStart == MaxInt32)
-			return false;
-
-		// Find closing brace
-		Int32 braceCount = 1;
-		Int32 pos = braceStart + 1;
-		USize jsonLength = json.GetLength ();
-		while (pos < (Int32)jsonLength && braceCount > 0) {
-			if (json[pos] == '{')
-				braceCount++;
-			else if (json[pos] == '}')
-				braceCount--;
-			pos++;
-		}
-		if (braceCount != 0)
-			return false;
-
-		GS::UniString pointJson = json.GetSubstring (braceStart, pos);
-
 		// Extract x, y (API_Coord only has x and y, no z)
-		coord.x = ExtractJsonDoubleValue (pointJson, "x");
-		coord.y = ExtractJsonDoubleValue (pointJson, "y");
+		coord.x = ExtractJsonDoubleValue (point, "x");
+		coord.y = ExtractJsonDoubleValue (point, "y");
 		// Note: z coordinate is ignored as API_Coord is 2D
 
 		return true;
 	}
 
 	// Extract GUID from JSON string value
-	bool ExtractGuidFromJson (const GS::UniString& json, const GS::UniString& guidKey, API_Guid& guid)
+	bool ExtractGuidFromJson (const JsonReader::Value& object, const char* guidKey, API_Guid& guid)
 	{
-		// Find GUID key: "elementGuid1": "guid-string"
-		GS::UniString searchKey = "\"" + guidKey + "\"";
-		Int32 keyPos = json.FindFirst (searchKey);
-		if (keyPos == MaxInt32)
-			return false;
-
-		// Find colon
-		Int32 colonPos = json.FindFirst (":", keyPos);
-		if (colonPos == MaxInt32)
+		// GUID member: "elementGuid1": "guid-string"
+		std::string guidStr;
+		if (!object.Find (guidKey).GetString (guidStr) || guidStr.empty ())
 			return false;
 
-		// Find opening quote
-		Int32 quoteStart = json.FindFirst ("\"", colonPos);
-		if (quoteStart == MaxInt32)
-			return false;
-
-		// Find closing quote
-		Int32 quoteEnd = json.FindFirst ("\"", quoteStart + 1);
-		if (quoteEnd == MaxInt32)
-			return false;
-
-		GS::UniString guidStr = json.GetSubstring (quoteStart + 1, quoteEnd);
-		if (guidStr.IsEmpty ())
-			return false;
-
-		guid = APIGuidFromString (guidStr.ToCStr ().Get ());
+		guid = APIGuidFromString (guidStr.c_str ());
 		return (guid != APINULLGuid);
 	}
 
 	// Handle CreateLinearDimension command
-	GS::UniString HandleCreateLinearDimensionCommand (const GS::UniString& payload)
+	GS::UniString HandleCreateLinearDimensionCommand (const JsonReader::Value& payload)
 	{
-		if (payload.IsEmpty ()) {
+		if (!payload.IsObject ()) {
 			return CreateJsonResponse (false, "Empty payload", GS::EmptyUniString);
 		}
 
@@ -212,11 +129,18 @@ namespace {
 		// Extract optional offset
 		offset = ExtractJsonDoubleValue (payload, "offset");
 
+		// Extract optional snap tolerance for the element attachment
+		double snapTolerance = DimensionHelper::DefaultSnapTolerance;
+		double toleranceValue = 0.0;
+		if (payload.Find ("snapTolerance").GetDouble (toleranceValue) && toleranceValue >= 0.0) {
+			snapTolerance = toleranceValue;
+		}
+
 		// Create dimension using DimensionHelper with optional element attachments
 		API_Guid createdDimensionGuid = APINULLGuid;
 		const API_Guid* guid1Ptr = (elementGuid1 != APINULLGuid) ? &elementGuid1 : nullptr;
 		const API_Guid* guid2Ptr = (elementGuid2 != APINULLGuid) ? &elementGuid2 : nullptr;
-		bool success = DimensionHelper::CreateLinearDimension (pt1, pt2, &createdDimensionGuid, nullptr, nullptr, guid1Ptr, guid2Ptr, GS::EmptyUniString, GS::EmptyUniString, GS::EmptyUniString, offset);
+		bool success = DimensionHelper::CreateLinearDimension (pt1, pt2, &createdDimensionGuid, nullptr, nullptr, guid1Ptr, guid2Ptr, GS::EmptyUniString, GS::EmptyUniString, GS::EmptyUniString, offset, snapTolerance);
 
 		if (success) {
 			GS::UniString result = "{\"created\":true}";
@@ -237,69 +161,27 @@ GS::UniString HandleJsonRequest (const GS::UniString& jsonRequest)
 		return CreateJsonResponse (false, "Empty request", GS::EmptyUniString);
 	}
 
+	// Tokenize the whole request once; all lookups below work on the DOM
+	const auto utf8 = jsonRequest.ToCStr (0, MaxUSize, CC_UTF8);
+	JsonReader::Document document;
+	if (!document.Parse (utf8.Get (), std::strlen (utf8.Get ())) || !document.GetRoot ().IsObject ()) {
+		GS::UniString message = "Invalid JSON request";
+		if (document.GetErrorMessage () != nullptr) {
+			message += GS::UniString::Printf (" at offset %u: ", (UInt32)document.GetErrorOffset ()) + document.GetErrorMessage ();
+		}
+		return CreateJsonResponse (false, message, GS::EmptyUniString);
+	}
+
+	JsonReader::Value root = document.GetRoot ();
+
 	// Extract command from JSON
-	GS::UniString command = ExtractJsonStringValue (jsonRequest, "command");
+	GS::UniString command = ExtractJsonStringValue (root, "command");
 	if (command.IsEmpty ()) {
 		return CreateJsonResponse (false, "Missing 'command' field", GS::EmptyUniString);
 	}
 
-	// Extract payload (if present) - simple extraction
-	GS::UniString payload;
-	Int32 payloadStart = jsonRequest.FindFirst ("\"payload\"");
-	if (payloadStart != MaxInt32) {
-		Int32 colonPos = jsonRequest.FindFirst (":", payloadStart);
-		if (colonPos != MaxInt32) {
-			// Skip whitespace after colon
-			Int32 valueStart = colonPos + 1;
-			USize jsonLength = jsonRequest.GetLength ();
-			while (valueStart < (Int32)jsonLength && 
-				   (jsonRequest[valueStart] == ' ' || jsonRequest[valueStart] == '\t')) {
-				valueStart++;
-			}
-			
-			// Check if it's an object
-			if (valueStart < (Int32)jsonLength && jsonRequest[valueStart] == '{') {
-				// Find matching closing brace
-				Int32 braceCount = 1;
-				Int32 pos = valueStart + 1;
-				while (pos < (Int32)jsonLength && braceCount > 0) {
-					if (jsonRequest[pos] == '{')
-						braceCount++;
-					else if (jsonRequest[pos] == '}')
-						braceCount--;
-					pos++;
-				}
-				if (braceCount == 0) {
-					payload = jsonRequest.GetSubstring (valueStart, pos);
-				}
-			} else if (valueStart < (Int32)jsonLength && jsonRequest[valueStart] == '[') {
-				// Array - find matching bracket
-				Int32 bracketCount = 1;
-				Int32 pos = valueStart + 1;
-				while (pos < (Int32)jsonLength && bracketCount > 0) {
-					if (jsonRequest[pos] == '[')
-						bracketCount++;
-					else if (jsonRequest[pos] == ']')
-						bracketCount--;
-					pos++;
-				}
-				if (bracketCount == 0) {
-					payload = jsonRequest.GetSubstring (valueStart, pos);
-				}
-			} else {
-				// Simple value (string, number, boolean, null) - find until comma or closing brace
-				Int32 pos = valueStart;
-				while (pos < (Int32)jsonLength) {
-					if (jsonRequest[pos] == ',' || jsonRequest[pos] == '}' || jsonRequest[pos] == ']')
-						break;
-					pos++;
-				}
-				if (pos > valueStart) {
-					payload = jsonRequest.GetSubstring (valueStart, pos);
-				}
-			}
-		}
-	}
+	// Payload (if present) - handed to the command handlers as a DOM node
+	JsonReader::Value payload = root.Find ("payload");
 
 	// Route to command handler
 	if (command == "Ping") {
@@ -48,27 +48,13 @@ static GS::Ref<JS::Base> ConvertToJavaScriptVariable (const GS::Array<Type>& cpp
 	return newArray;
 }
 
-// -----------------------------------------------------------------------------
-// Project event handler function
-// -----------------------------------------------------------------------------
-static GSErrCode NotificationHandler (API_NotifyEventID notifID, Int32 /*param*/)
-{
-	switch (notifID) {
-		case APINotify_Quit:
-			BrowserPalette::DestroyInstance ();
-			break;
-	}
-
-	return NoError;
-}   // NotificationHandler
-
 // --- Class definition: BrowserPalette ----------------------------------------
 
 BrowserPalette::BrowserPalette () :
 	DG::Palette (ACAPI_GetOwnResModule (), BrowserPaletteResId, ACAPI_GetOwnResModule (), paletteGuid),
 	browser (GetReference (), BrowserId)
 {
-	ACAPI_ProjectOperation_CatchProjectEvent (APINotify_Quit, NotificationHandler);
+	// APINotify_Quit is dispatched by the add-on's ProjectEventHandler (Main.cpp)
 	Attach (*this);
 	BeginEventProcessing ();
 	InitBrowserControl ();
@@ -0,0 +1,181 @@
+// *****************************************************************************
+// Source code for ChangeFeed module (revisioned log of tracked element changes)
+// *****************************************************************************
+
+#include "ChangeFeed.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace ChangeFeed {
+
+	namespace {
+		constexpr UInt32 Capacity = 16384;
+
+		std::vector<Change>	g_ring;					// circular, oldest entry at g_first
+		UInt32				g_first = 0;
+		UInt32				g_count = 0;
+		UInt64				g_revision = 0;
+		UInt64				g_resyncBefore = 0;		// deltas since an older revision are gone
+		bool				g_shutdown = false;
+
+		std::mutex				g_mutex;			// guards everything above
+		std::condition_variable	g_changed;
+
+		bool IsDeltaAvailable (UInt64 sinceRevision)
+		{
+			return sinceRevision >= g_resyncBefore && sinceRevision <= g_revision;
+		}
+
+		// Combine two changes of the same element seen by a client in one delta
+		// Returns false if the element must not appear in the delta at all
+		bool Coalesce (Change& previous, const Change& next)
+		{
+			if (previous.kind == ChangeKind::Added && next.kind == ChangeKind::Deleted) {
+				return false;				// the client never saw it
+			}
+
+			ChangeKind kind = next.kind;
+			if (previous.kind == ChangeKind::Added) {
+				kind = ChangeKind::Added;		// still new for the client
+			} else if (previous.kind == ChangeKind::Deleted && next.kind == ChangeKind::Added) {
+				kind = ChangeKind::Modified;	// deleted and restored (undo)
+			}
+
+			const bool hasPosition = next.hasPosition || previous.hasPosition;
+			const API_Coord position = next.hasPosition ? next.position : previous.position;
+			previous = next;
+			previous.kind = kind;
+			previous.hasPosition = hasPosition;
+			previous.position = position;
+			return true;
+		}
+	}
+
+	void Record (ChangeKind kind, const API_Guid& guid, API_ElemTypeID type, const API_Coord* position)
+	{
+		if (guid == APINULLGuid) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock (g_mutex);
+
+		Change change;
+		change.guid = guid;
+		change.type = type;
+		change.kind = kind;
+		change.revision = ++g_revision;
+		if (position != nullptr) {
+			change.hasPosition = true;
+			change.position = *position;
+		}
+
+		if (g_ring.size () < Capacity) {
+			g_ring.resize (Capacity);
+		}
+		if (g_count == Capacity) {
+			// Overwrite the oldest entry - clients behind it must resync
+			g_resyncBefore = g_ring[g_first].revision;
+			g_ring[g_first] = change;
+			g_first = (g_first + 1) % Capacity;
+		} else {
+			g_ring[(g_first + g_count) % Capacity] = change;
+			++g_count;
+		}
+		g_changed.notify_all ();
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close: {
+				// GUIDs of the previous project mean nothing now
+				std::lock_guard<std::mutex> lock (g_mutex);
+				g_first = 0;
+				g_count = 0;
+				g_resyncBefore = ++g_revision;
+				g_changed.notify_all ();
+				break;
+			}
+
+			case APINotify_Quit:
+				Shutdown ();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	UInt64 GetRevision ()
+	{
+		std::lock_guard<std::mutex> lock (g_mutex);
+		return g_revision;
+	}
+
+	bool GetChangesSince (UInt64 sinceRevision, GS::Array<Change>& changes, UInt64& currentRevision)
+	{
+		changes.Clear ();
+
+		std::lock_guard<std::mutex> lock (g_mutex);
+		currentRevision = g_revision;
+
+		// Unknown future revision: the add-on was reloaded since the client last asked
+		if (!IsDeltaAvailable (sinceRevision)) {
+			return false;
+		}
+
+		GS::HashTable<API_Guid, UIndex> indexByGuid;
+		GS::Array<bool> dropped;
+		for (UInt32 i = 0; i < g_count; ++i) {
+			const Change& change = g_ring[(g_first + i) % Capacity];
+			if (change.revision <= sinceRevision) {
+				continue;
+			}
+
+			const UIndex* index = indexByGuid.GetPtr (change.guid);
+			if (index == nullptr) {
+				indexByGuid.Add (change.guid, changes.GetSize ());
+				changes.Push (change);
+				dropped.Push (false);
+			} else if (dropped[*index]) {
+				// Seen as added and deleted already; anything later starts over
+				changes[*index] = change;
+				dropped[*index] = false;
+			} else if (!Coalesce (changes[*index], change)) {
+				dropped[*index] = true;
+			}
+		}
+
+		GS::Array<Change> result;
+		result.SetCapacity (changes.GetSize ());
+		for (UIndex i = 0; i < changes.GetSize (); ++i) {
+			if (!dropped[i]) {
+				result.Push (changes[i]);
+			}
+		}
+		changes = result;
+		return true;
+	}
+
+	bool WaitForChanges (UInt64 sinceRevision, UInt32 timeoutMs)
+	{
+		std::unique_lock<std::mutex> lock (g_mutex);
+		g_changed.wait_for (lock, std::chrono::milliseconds (timeoutMs), [sinceRevision] () {
+			return g_shutdown || g_revision > sinceRevision || !IsDeltaAvailable (sinceRevision);
+		});
+		return g_revision > sinceRevision || !IsDeltaAvailable (sinceRevision);
+	}
+
+	void Shutdown ()
+	{
+		std::lock_guard<std::mutex> lock (g_mutex);
+		g_shutdown = true;
+		g_changed.notify_all ();
+	}
+
+} // namespace ChangeFeed
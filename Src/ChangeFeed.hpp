@@ -0,0 +1,64 @@
+// *****************************************************************************
+// Header file for ChangeFeed module (revisioned log of tracked element changes)
+// *****************************************************************************
+
+#ifndef CHANGEFEED_HPP
+#define CHANGEFEED_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// Every change of an element tracked by HotspotManager / DimensionManager
+// (added, modified, deleted) gets the next value of a monotonically
+// increasing revision counter and goes into a bounded ring buffer.
+//
+// Clients remember the revision of their last refresh and ask for the delta
+// since then. When the ring buffer has already dropped entries newer than
+// that revision (or the project was switched), the client must resync.
+//
+// Thread safety: recording happens on the main thread (notifications,
+// commands); GetChangesSince and WaitForChanges may be called from any
+// thread. Entries carry everything needed to answer off the main thread.
+// -----------------------------------------------------------------------------
+
+namespace ChangeFeed {
+
+	enum class ChangeKind {
+		Added,
+		Modified,
+		Deleted
+	};
+
+	struct Change {
+		API_Guid		guid = APINULLGuid;
+		API_ElemTypeID	type = API_ZombieElemID;
+		ChangeKind		kind = ChangeKind::Modified;
+		UInt64			revision = 0;
+		bool			hasPosition = false;	// hotspots: position after the change
+		API_Coord		position = {};
+	};
+
+	// Record a change of a tracked element (position: new hotspot position, if known)
+	void		Record (ChangeKind kind, const API_Guid& guid, API_ElemTypeID type, const API_Coord* position = nullptr);
+
+	// Forward project events (APINotify_*) - a project switch invalidates all revisions
+	void		OnProjectEvent (API_NotifyEventID notifID);
+
+	// Revision of the latest recorded change
+	UInt64		GetRevision ();
+
+	// Changes after sinceRevision, one entry per element (latest kind wins)
+	// Returns false if the delta is no longer available and the client must resync
+	bool		GetChangesSince (UInt64 sinceRevision, GS::Array<Change>& changes, UInt64& currentRevision);
+
+	// Block the calling (non-main) thread until there is something after sinceRevision,
+	// the timeout expires or the add-on shuts down. Returns true if there is something to fetch.
+	bool		WaitForChanges (UInt64 sinceRevision, UInt32 timeoutMs);
+
+	// Wake all waiters and refuse new waits - called on quit / unload
+	void		Shutdown ();
+
+} // namespace ChangeFeed
+
+#endif // CHANGEFEED_HPP
@@ -0,0 +1,74 @@
+// *****************************************************************************
+// Source code for DefaultsCache module (element default templates)
+// *****************************************************************************
+
+#include "DefaultsCache.hpp"
+
+namespace DefaultsCache {
+
+	namespace {
+		struct Template {
+			API_ElemTypeID	typeID = API_ZombieElemID;
+			API_Element		element = {};
+		};
+
+		// A handful of types - a linear search beats hashing
+		GS::Array<Template>	g_templates;
+
+		GSErrCode DefaultsChangeHandler (const API_ToolBoxItem* /*defElemType*/)
+		{
+			// Cheap to refill, so any change drops every template
+			Invalidate ();
+			return NoError;
+		}
+	}
+
+	GSErrCode Initialize ()
+	{
+		// nullptr: defaults of every element type
+		return ACAPI_Element_CatchChangeDefaults (nullptr, DefaultsChangeHandler);
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close:
+				// Tool defaults are stored with the project
+				Invalidate ();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	GSErrCode GetDefaults (API_ElemTypeID typeID, API_Element& element)
+	{
+		for (const Template& cached : g_templates) {
+			if (cached.typeID == typeID) {
+				element = cached.element;
+				return NoError;
+			}
+		}
+
+		Template added;
+		added.typeID = typeID;
+		added.element.header.type = typeID;
+		GSErrCode err = ACAPI_Element_GetDefaults (&added.element, nullptr);
+		if (err != NoError) {
+			return err;
+		}
+		g_templates.Push (added);
+		element = added.element;
+		return NoError;
+	}
+
+	void Invalidate ()
+	{
+		g_templates.Clear ();
+	}
+
+} // namespace DefaultsCache
@@ -0,0 +1,39 @@
+// *****************************************************************************
+// Header file for DefaultsCache module (element default templates)
+// *****************************************************************************
+
+#ifndef DEFAULTSCACHE_HPP
+#define DEFAULTSCACHE_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// Tool defaults of the element types this add-on creates (dimensions,
+// hotspots), read with ACAPI_Element_GetDefaults once and then copied for
+// every new element instead of being read from the database each time.
+//
+// Templates are dropped when the user changes tool defaults (default change
+// notification), when the active story changes (SpatialIndex forwards its view
+// event) and on project events, and are read again on next use.
+// Only the element part is cached - callers needing default memos still
+// call ACAPI_Element_GetDefaults themselves.
+// -----------------------------------------------------------------------------
+
+namespace DefaultsCache {
+
+	// Install the default change handler - call once from Initialize
+	GSErrCode	Initialize ();
+
+	// Forward project events (APINotify_*)
+	void		OnProjectEvent (API_NotifyEventID notifID);
+
+	// Fill element with the defaults of typeID (header.type set, everything else from the template)
+	GSErrCode	GetDefaults (API_ElemTypeID typeID, API_Element& element);
+
+	// Drop every template
+	void		Invalidate ();
+
+} // namespace DefaultsCache
+
+#endif // DEFAULTSCACHE_HPP
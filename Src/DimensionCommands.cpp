@@ -2,10 +2,24 @@
 // Source code for Dimension Commands
 // *****************************************************************************
 
+#include <algorithm>
 #include <cstring>
+#include <vector>
 #include "DimensionCommands.hpp"
 #include "ObjectState.hpp"
 #include "DimensionHelper.hpp"
+#include "ElementTracker.hpp"
+#include "SpatialIndex.hpp"
+#include "ChangeFeed.hpp"
+#include "UndoSession.hpp"
+#include "LiveDrag.hpp"
+#include "DimensionSets.hpp"
+#include "HotspotSweeper.hpp"
+#include "TrackingStore.hpp"
+#include "JobQueue.hpp"
+#include "BatchPipeline.hpp"
+#include "PlacementKernel.hpp"
+#include "DefaultsCache.hpp"
 
 // -----------------------------------------------------------------------------
 // GetPortCommand implementation
@@ -149,6 +163,9 @@ GS::Optional<GS::UniString> GetDimensionsCommand::GetResponseSchema () const
 					"items": {
 						"type": "object"
 					}
+				},
+				"nextCursor": {
+					"type": "string"
 				}
 			},
 			"additionalProperties": false,
@@ -157,12 +174,222 @@ GS::Optional<GS::UniString> GetDimensionsCommand::GetResponseSchema () const
 	)";
 }
 
-GS::ObjectState GetDimensionsCommand::Execute (const GS::ObjectState& /*parameters*/, GS::ProcessControl& /*processControl*/) const
+namespace {
+	constexpr UInt32 DefaultDimensionPageSize = 500;
+	constexpr UInt32 MaxDimensionPageSize = 5000;
+
+	struct DimensionQuery {
+		bool				filterStory = false;
+		short				storyIndex = 0;
+		bool				filterLayer = false;
+		API_AttributeIndex	layerIndex = {};
+		bool				filterBox = false;
+		API_Box				box = {};
+		bool				trackedOnly = false;
+		bool				compact = false;
+		API_Guid			cursor = APINULLGuid;
+		UInt32				limit = DefaultDimensionPageSize;
+	};
+
+	bool GuidLess (const API_Guid& a, const API_Guid& b)
+	{
+		return memcmp (&a, &b, sizeof (API_Guid)) < 0;
+	}
+
+	bool MatchesDimensionQuery (const API_Elem_Head& header, const DimensionQuery& query)
+	{
+		if (query.filterStory && header.floorInd != query.storyIndex) {
+			return false;
+		}
+		if (query.filterLayer && !(header.layer == query.layerIndex)) {
+			return false;
+		}
+		if (query.filterBox) {
+			API_Box3D bounds = {};
+			if (ACAPI_Element_CalcBounds (&header, &bounds) != NoError) {
+				return false;
+			}
+			if (bounds.xMax < query.box.xMin || bounds.xMin > query.box.xMax ||
+				bounds.yMax < query.box.yMin || bounds.yMin > query.box.yMax) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Full form: { guid, storyIndex, tracked, refC, direction, nodes: [ {x, y, hotspotGuid?} ] }
+	// Compact form: { guid, nodes: [x0, y0, x1, y1, ...] }
+	bool DimensionToObjectState (const API_Guid& dimensionGuid, bool compact, GS::ObjectState& dimensionOS)
+	{
+		API_Element dim = {};
+		dim.header.guid = dimensionGuid;
+		if (ACAPI_Element_Get (&dim) != NoError) {
+			return false;
+		}
+
+		API_ElementMemo memo = {};
+		if (ACAPI_Element_GetMemo (dimensionGuid, &memo) != NoError) {
+			return false;
+		}
+
+		const Int32 nodeCount = (memo.dimElems != nullptr) ? dim.dimension.nDimElem : 0;
+		dimensionOS.Add ("guid", APIGuidToString (dimensionGuid));
+		if (compact) {
+			GS::Array<double> packed;
+			packed.SetCapacity (2 * nodeCount);
+			for (Int32 i = 0; i < nodeCount; ++i) {
+				packed.Push ((*memo.dimElems)[i].base.loc.x);
+				packed.Push ((*memo.dimElems)[i].base.loc.y);
+			}
+			dimensionOS.Add ("nodes", packed);
+		} else {
+			GS::Array<GS::ObjectState> nodes;
+			nodes.SetCapacity (nodeCount);
+			for (Int32 i = 0; i < nodeCount; ++i) {
+				const API_DimElem& dimElem = (*memo.dimElems)[i];
+				GS::ObjectState nodeOS;
+				nodeOS.Add ("x", dimElem.base.loc.x);
+				nodeOS.Add ("y", dimElem.base.loc.y);
+				if (dimElem.base.base.type == API_HotspotID) {
+					nodeOS.Add ("hotspotGuid", APIGuidToString (dimElem.base.base.guid));
+				}
+				nodes.Push (nodeOS);
+			}
+
+			GS::ObjectState refCOS;
+			refCOS.Add ("x", dim.dimension.refC.x);
+			refCOS.Add ("y", dim.dimension.refC.y);
+			GS::ObjectState directionOS;
+			directionOS.Add ("x", dim.dimension.direction.x);
+			directionOS.Add ("y", dim.dimension.direction.y);
+
+			dimensionOS.Add ("storyIndex", (Int32)dim.header.floorInd);
+			dimensionOS.Add ("tracked", DimensionManager::IsTrackedDimension (dimensionGuid));
+			dimensionOS.Add ("refC", refCOS);
+			dimensionOS.Add ("direction", directionOS);
+			dimensionOS.Add ("nodes", nodes);
+		}
+
+		ACAPI_DisposeElemMemoHdls (&memo);
+		return true;
+	}
+}
+
+// Input:  { "storyIndex", "layer", "bbox": {xMin, yMin, xMax, yMax}, "trackedOnly", "compact", "cursor", "limit" } (all optional)
+// Output: { "dimensions": [ ... ], "nextCursor", "cancelled" }
+// Dimensions are ordered by GUID; nextCursor is the last GUID of the page, empty on the last page.
+// A cancelled request returns the page so far, with nextCursor set to resume after it
+GS::ObjectState GetDimensionsCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const
 {
-	// TODO: Implement actual dimension retrieval
+	DimensionQuery query;
+	if (parameters.Contains ("storyIndex")) {
+		Int32 storyIndex = 0;
+		if (parameters.Get ("storyIndex", storyIndex)) {
+			query.filterStory = true;
+			query.storyIndex = (short)storyIndex;
+		}
+	}
+	if (parameters.Contains ("layer")) {
+		GS::UniString layerName;
+		if (parameters.Get ("layer", layerName) && !layerName.IsEmpty ()) {
+			API_Attribute layer = {};
+			layer.header.typeID = API_LayerID;
+			layer.header.uniStringNamePtr = &layerName;
+			if (ACAPI_Attribute_Get (&layer) != NoError) {
+				GS::ObjectState result;
+				result.Add ("dimensions", GS::Array<GS::ObjectState> ());
+				result.Add ("nextCursor", GS::EmptyUniString);
+				return result;
+			}
+			query.filterLayer = true;
+			query.layerIndex = layer.header.index;
+		}
+	}
+	if (parameters.Contains ("bbox")) {
+		GS::ObjectState boxOS;
+		if (parameters.Get ("bbox", boxOS) &&
+			boxOS.Get ("xMin", query.box.xMin) && boxOS.Get ("yMin", query.box.yMin) &&
+			boxOS.Get ("xMax", query.box.xMax) && boxOS.Get ("yMax", query.box.yMax)) {
+			query.filterBox = true;
+		}
+	}
+	if (parameters.Contains ("trackedOnly")) {
+		parameters.Get ("trackedOnly", query.trackedOnly);
+	}
+	if (parameters.Contains ("compact")) {
+		parameters.Get ("compact", query.compact);
+	}
+	if (parameters.Contains ("cursor")) {
+		GS::UniString cursor;
+		if (parameters.Get ("cursor", cursor) && !cursor.IsEmpty ()) {
+			query.cursor = APIGuidFromString (cursor.ToCStr ().Get ());
+		}
+	}
+	if (parameters.Contains ("limit")) {
+		Int32 limit = 0;
+		if (parameters.Get ("limit", limit) && limit > 0) {
+			query.limit = std::min ((UInt32)limit, MaxDimensionPageSize);
+		}
+	}
+
+	// Candidates: tracked dimensions only, or every dimension in the project
+	GS::Array<API_Guid> candidates;
+	if (query.trackedOnly) {
+		candidates = DimensionManager::GetAllDimensions ();
+	} else {
+		ACAPI_Element_GetElemList (API_DimensionID, &candidates);
+	}
+
+	// GUID order keeps the cursor valid while dimensions are added or deleted between pages
+	std::vector<API_Guid> ordered;
+	ordered.reserve (candidates.GetSize ());
+	for (const API_Guid& guid : candidates) {
+		ordered.push_back (guid);
+	}
+	std::sort (ordered.begin (), ordered.end (), GuidLess);
+	auto it = ordered.begin ();
+	if (query.cursor != APINULLGuid) {
+		it = std::upper_bound (ordered.begin (), ordered.end (), query.cursor, GuidLess);
+	}
+
+	GS::Array<GS::ObjectState> dimensions;
+	dimensions.SetCapacity (std::min ((UInt32)(ordered.end () - it), query.limit));
+	API_Guid lastGuid = APINULLGuid;
+	bool hasMore = false;
+	bool cancelled = false;
+	for (; it != ordered.end (); ++it) {
+		if (dimensions.GetSize () >= query.limit) {
+			hasMore = true;
+			break;
+		}
+		if (processControl.IsBreaked ()) {
+			// Resume after the last candidate looked at, even if it was filtered out
+			cancelled = true;
+			hasMore = true;
+			lastGuid = (it != ordered.begin ()) ? *(it - 1) : query.cursor;
+			break;
+		}
+
+		API_Elem_Head header = {};
+		header.guid = *it;
+		if (ACAPI_Element_GetHeader (&header) != NoError || header.type != API_DimensionID) {
+			continue;
+		}
+		if (!MatchesDimensionQuery (header, query)) {
+			continue;
+		}
+
+		GS::ObjectState dimensionOS;
+		if (DimensionToObjectState (*it, query.compact, dimensionOS)) {
+			dimensions.Push (dimensionOS);
+			lastGuid = *it;
+		}
+	}
+
 	GS::ObjectState result;
-	GS::Array<GS::ObjectState> dimensions; // Empty array for now
 	result.Add ("dimensions", dimensions);
+	result.Add ("nextCursor", hasMore ? APIGuidToString (lastGuid) : GS::EmptyUniString);
+	result.Add ("cancelled", cancelled);
 	return result;
 }
 
@@ -174,16 +401,6 @@ void GetDimensionsCommand::OnResponseValidationFailed (const GS::ObjectState& /*
 // CreateLinearDimensionCommand implementation
 // -----------------------------------------------------------------------------
 
-// =============================================================================
-// DimensionManager - track created dimensions to avoid duplicates
-// Forward declaration - implementation is after CreateLinearDimensionCommand
-// =============================================================================
-
-namespace DimensionManager {
-	API_Guid FindExistingDimension(const API_Guid& hotspot1, const API_Guid& hotspot2);
-	void AddDimension(const API_Guid& hotspot1, const API_Guid& hotspot2, const API_Guid& dimensionGuid);
-}
-
 // =============================================================================
 // CreateLinearDimensionCommand implementation
 // =============================================================================
@@ -216,6 +433,11 @@ GS::Optional<GS::UniString> CreateLinearDimensionCommand::GetResponseSchema () c
 
 GS::ObjectState CreateLinearDimensionCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
 {
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
 	// Extract point1 and point2 from parameters
 	API_Coord pt1 = {};
 	API_Coord pt2 = {};
@@ -259,21 +481,22 @@ GS::ObjectState CreateLinearDimensionCommand::Execute (const GS::ObjectState& pa
 		GS::UniString guidStr1;
 		if (parameters.Get ("hotspotGuid1", guidStr1) && !guidStr1.IsEmpty()) {
 			hotspotGuid1 = APIGuidFromString(guidStr1.ToCStr().Get());
-			// Get hotspot element to find the element it's attached to
-			API_Element hotspot = {};
-			hotspot.header.guid = hotspotGuid1;
-			if (ACAPI_Element_Get(&hotspot) == NoError && hotspot.header.type == API_HotspotID) {
-				// Find element at hotspot position
-				API_ElemSearchPars searchPars = {};
-				searchPars.type = API_ZombieElemID;
-				searchPars.loc.x = hotspot.hotspot.pos.x;
-				searchPars.loc.y = hotspot.hotspot.pos.y;
-				searchPars.z = 1.00E6;
-				searchPars.filterBits = APIFilt_OnVisLayer | APIFilt_OnActFloor;
-				API_Guid foundGuid = APINULLGuid;
-				if (ACAPI_Element_SearchElementByCoord(&searchPars, &foundGuid) == NoError) {
-					elementGuid1 = foundGuid;
-				}
+		}
+	}
+	// Hotspot can also be referenced by rhinoPointGuid (e.g. created earlier in the same session)
+	if (hotspotGuid1 == APINULLGuid && parameters.Contains ("rhinoPointGuid1")) {
+		GS::UniString rhinoPointGuid1;
+		if (parameters.Get ("rhinoPointGuid1", rhinoPointGuid1) && !rhinoPointGuid1.IsEmpty()) {
+			hotspotGuid1 = HotspotManager::FindHotspotByRhinoGuid(rhinoPointGuid1);
+		}
+	}
+	if (hotspotGuid1 != APINULLGuid) {
+		// Find the element under the hotspot (position and element both come from the spatial index)
+		API_Coord hotspotPos = {};
+		if (SpatialIndex::GetHotspotPosition(hotspotGuid1, hotspotPos)) {
+			API_Guid foundGuid = APINULLGuid;
+			if (SpatialIndex::FindElementAt(hotspotPos, foundGuid)) {
+				elementGuid1 = foundGuid;
 			}
 		}
 	}
@@ -282,21 +505,22 @@ GS::ObjectState CreateLinearDimensionCommand::Execute (const GS::ObjectState& pa
 		GS::UniString guidStr2;
 		if (parameters.Get ("hotspotGuid2", guidStr2) && !guidStr2.IsEmpty()) {
 			hotspotGuid2 = APIGuidFromString(guidStr2.ToCStr().Get());
-			// Get hotspot element to find the element it's attached to
-			API_Element hotspot = {};
-			hotspot.header.guid = hotspotGuid2;
-			if (ACAPI_Element_Get(&hotspot) == NoError && hotspot.header.type == API_HotspotID) {
-				// Find element at hotspot position
-				API_ElemSearchPars searchPars = {};
-				searchPars.type = API_ZombieElemID;
-				searchPars.loc.x = hotspot.hotspot.pos.x;
-				searchPars.loc.y = hotspot.hotspot.pos.y;
-				searchPars.z = 1.00E6;
-				searchPars.filterBits = APIFilt_OnVisLayer | APIFilt_OnActFloor;
-				API_Guid foundGuid = APINULLGuid;
-				if (ACAPI_Element_SearchElementByCoord(&searchPars, &foundGuid) == NoError) {
-					elementGuid2 = foundGuid;
-				}
+		}
+	}
+	// Hotspot can also be referenced by rhinoPointGuid (e.g. created earlier in the same session)
+	if (hotspotGuid2 == APINULLGuid && parameters.Contains ("rhinoPointGuid2")) {
+		GS::UniString rhinoPointGuid2;
+		if (parameters.Get ("rhinoPointGuid2", rhinoPointGuid2) && !rhinoPointGuid2.IsEmpty()) {
+			hotspotGuid2 = HotspotManager::FindHotspotByRhinoGuid(rhinoPointGuid2);
+		}
+	}
+	if (hotspotGuid2 != APINULLGuid) {
+		// Find the element under the hotspot (position and element both come from the spatial index)
+		API_Coord hotspotPos = {};
+		if (SpatialIndex::GetHotspotPosition(hotspotGuid2, hotspotPos)) {
+			API_Guid foundGuid = APINULLGuid;
+			if (SpatialIndex::FindElementAt(hotspotPos, foundGuid)) {
+				elementGuid2 = foundGuid;
 			}
 		}
 	}
@@ -356,6 +580,15 @@ GS::ObjectState CreateLinearDimensionCommand::Execute (const GS::ObjectState& pa
 		}
 	}
 
+	// Extract optional snap tolerance for the element attachment fallback
+	double snapTolerance = DimensionHelper::DefaultSnapTolerance;
+	if (parameters.Contains ("snapTolerance")) {
+		double toleranceValue = 0.0;
+		if (parameters.Get ("snapTolerance", toleranceValue) && toleranceValue >= 0.0) {
+			snapTolerance = toleranceValue;
+		}
+	}
+
 	// Check if dimension already exists for this hotspot pair
 	API_Guid existingDimensionGuid = APINULLGuid;
 	if (hotspotGuid1 != APINULLGuid && hotspotGuid2 != APINULLGuid) {
@@ -379,14 +612,18 @@ GS::ObjectState CreateLinearDimensionCommand::Execute (const GS::ObjectState& pa
 	const API_Guid* elementGuid2Ptr = (elementGuid2 != APINULLGuid) ? &elementGuid2 : nullptr;
 	
 	API_Guid createdDimensionGuid = APINULLGuid;
-	bool success = DimensionHelper::CreateLinearDimension (pt1, pt2, &createdDimensionGuid, hotspotGuid1Ptr, hotspotGuid2Ptr, elementGuid1Ptr, elementGuid2Ptr, GS::EmptyUniString, GS::EmptyUniString, GS::EmptyUniString, offset);
+	bool success = false;
+	UndoSession::RunUndoable ("CreateLinearDimension", [&]() -> GSErrCode {
+		success = DimensionHelper::CreateLinearDimensionInUndoScope (pt1, pt2, &createdDimensionGuid, hotspotGuid1Ptr, hotspotGuid2Ptr, elementGuid1Ptr, elementGuid2Ptr, GS::EmptyUniString, GS::EmptyUniString, GS::EmptyUniString, offset, snapTolerance);
+		// Register dimension in tracking system (in the same undo step, see TrackingStore)
+		if (success && createdDimensionGuid != APINULLGuid && hotspotGuid1 != APINULLGuid && hotspotGuid2 != APINULLGuid) {
+			DimensionManager::AddDimension(hotspotGuid1, hotspotGuid2, createdDimensionGuid);
+		}
+		return success ? NoError : APIERR_GENERAL;
+	});
 
 	GS::ObjectState response;
 	if (success && createdDimensionGuid != APINULLGuid) {
-		// Register dimension in tracking system
-		if (hotspotGuid1 != APINULLGuid && hotspotGuid2 != APINULLGuid) {
-			DimensionManager::AddDimension(hotspotGuid1, hotspotGuid2, createdDimensionGuid);
-		}
 		response.Add ("success", true);
 		response.Add ("distance", distance);
 		response.Add ("dimensionGuid", APIGuidToString(createdDimensionGuid));
@@ -409,203 +646,554 @@ void CreateLinearDimensionCommand::OnResponseValidationFailed (const GS::ObjectS
 // =============================================================================
 
 namespace HotspotManager {
-	static GS::Array<API_Guid> g_createdHotspots;
-	// Map: rhinoPointGuid (string) -> hotspotGuid (API_Guid)
-	static GS::HashTable<GS::UniString, API_Guid> g_rhinoToHotspotMap;
+	// Tracked hotspots plus a bidirectional rhinoPointGuid <-> hotspotGuid index
+	// Rhino GUIDs are stored as 128-bit binary keys (see RhinoKeyFromString)
+	static GS::HashSet<API_Guid> g_createdHotspots;
+	static GS::HashTable<API_Guid, API_Guid> g_rhinoToHotspotMap;
+	static GS::HashTable<API_Guid, API_Guid> g_hotspotToRhinoMap;
+	
+	API_Guid RhinoKeyFromString(const GS::UniString& rhinoPointGuid)
+	{
+		if (rhinoPointGuid.IsEmpty()) {
+			return APINULLGuid;
+		}
+		
+		API_Guid key = APIGuidFromString(rhinoPointGuid.ToCStr().Get());
+		if (key != APINULLGuid) {
+			return key;
+		}
+		
+		// Not a GUID (custom point id) - fold the string into 128 bits with two FNV-1a passes
+		UInt64 hash[2] = { 0xCBF29CE484222325ULL, 0x84222325CBF29CE4ULL };
+		const auto utf8 = rhinoPointGuid.ToCStr(0, MaxUSize, CC_UTF8);
+		for (const char* p = utf8.Get(); *p != '\0'; ++p) {
+			const UInt64 ch = (UInt64)(unsigned char)*p;
+			hash[0] = (hash[0] ^ ch) * 0x100000001B3ULL;
+			hash[1] = (hash[1] ^ (ch + 0x9E)) * 0x100000001B3ULL;
+		}
+		static_assert(sizeof(hash) == sizeof(API_Guid), "API_Guid must be 128 bits");
+		memcpy(&key, hash, sizeof(API_Guid));
+		return key;
+	}
+	
+	// Drop the rhino mapping of a hotspot (both directions)
+	static void UnmapHotspot(const API_Guid& hotspotGuid)
+	{
+		const API_Guid* rhinoKey = g_hotspotToRhinoMap.GetPtr(hotspotGuid);
+		if (rhinoKey == nullptr) {
+			return;
+		}
+		const API_Guid* mapped = g_rhinoToHotspotMap.GetPtr(*rhinoKey);
+		if (mapped != nullptr && *mapped == hotspotGuid) {
+			g_rhinoToHotspotMap.Delete(*rhinoKey);
+		}
+		g_hotspotToRhinoMap.Delete(hotspotGuid);
+	}
+	
+	// Track a hotspot and map it to its rhino key (if any)
+	static void TrackHotspot(const API_Guid& hotspotGuid, const API_Guid& rhinoKey)
+	{
+		g_createdHotspots.Add(hotspotGuid);
+		ElementTracker::Track(hotspotGuid, API_HotspotID);
+		
+		if (rhinoKey == APINULLGuid) {
+			return;
+		}
+		
+		// Re-mapping: forget the previous partners on both sides
+		UnmapHotspot(hotspotGuid);
+		const API_Guid* previous = g_rhinoToHotspotMap.GetPtr(rhinoKey);
+		if (previous != nullptr) {
+			g_hotspotToRhinoMap.Delete(*previous);
+			g_rhinoToHotspotMap.Delete(rhinoKey);
+		}
+		
+		g_rhinoToHotspotMap.Add(rhinoKey, hotspotGuid);
+		g_hotspotToRhinoMap.Add(hotspotGuid, rhinoKey);
+	}
 	
 	void AddHotspot(const API_Guid& hotspotGuid, const GS::UniString& rhinoPointGuid)
+	{
+		if (hotspotGuid == APINULLGuid) {
+			return;
+		}
+		
+		TrackingStore::EnsureLoaded();
+		const API_Guid rhinoKey = RhinoKeyFromString(rhinoPointGuid);
+		const API_Guid* previous = g_rhinoToHotspotMap.GetPtr(rhinoKey);
+		if (previous != nullptr && *previous != hotspotGuid) {
+			TrackingStore::MarkHotspotDirty(*previous);	// loses its rhino key
+		}
+		TrackHotspot(hotspotGuid, rhinoKey);
+		TrackingStore::MarkHotspotDirty(hotspotGuid);
+	}
+	
+	void RestoreHotspot(const API_Guid& hotspotGuid, const API_Guid& rhinoKey)
 	{
 		if (hotspotGuid != APINULLGuid) {
-			g_createdHotspots.Push(hotspotGuid);
-			if (!rhinoPointGuid.IsEmpty()) {
-				g_rhinoToHotspotMap.Add(rhinoPointGuid, hotspotGuid);
-			}
+			TrackHotspot(hotspotGuid, rhinoKey);
 		}
 	}
 	
 	void RemoveHotspot(const API_Guid& hotspotGuid)
 	{
-		for (UIndex i = 0; i < g_createdHotspots.GetSize(); ++i) {
-			// Compare GUIDs using memcmp (API_Guid doesn't have == operator in AC27)
-			if (memcmp(&g_createdHotspots[i], &hotspotGuid, sizeof(API_Guid)) == 0) {
-				g_createdHotspots.Delete(i);
-				// Remove from map
-				// Need to collect keys first, then delete (can't delete during iteration)
-				GS::Array<GS::UniString> keysToDelete;
-				for (auto it = g_rhinoToHotspotMap.Begin(); it != g_rhinoToHotspotMap.End(); ++it) {
-					// Compare GUIDs using memcmp
-					if (memcmp(&it->value, &hotspotGuid, sizeof(API_Guid)) == 0) {
-						// Get key value
-						keysToDelete.Push(it->key);
-						break;
-					}
-				}
-				// Delete collected keys
-				for (UIndex i = 0; i < keysToDelete.GetSize(); ++i) {
-					g_rhinoToHotspotMap.Delete(keysToDelete[i]);
-				}
-				break;
-			}
+		TrackingStore::EnsureLoaded();
+		if (!g_createdHotspots.Contains(hotspotGuid)) {
+			return;
 		}
+		g_createdHotspots.Delete(hotspotGuid);
+		TrackingStore::MarkHotspotDirty(hotspotGuid);
+		ElementTracker::Untrack(hotspotGuid);
+		SpatialIndex::RemoveHotspot(hotspotGuid);
+		DimensionSets::ForgetHotspot(hotspotGuid);
+		UnmapHotspot(hotspotGuid);
+	}
+	
+	bool IsTrackedHotspot(const API_Guid& hotspotGuid)
+	{
+		TrackingStore::EnsureLoaded();
+		return g_createdHotspots.Contains(hotspotGuid);
 	}
 	
 	// Find hotspot by rhinoPointGuid
 	API_Guid FindHotspotByRhinoGuid(const GS::UniString& rhinoPointGuid)
 	{
-		if (rhinoPointGuid.IsEmpty()) {
+		TrackingStore::EnsureLoaded();
+		const API_Guid rhinoKey = RhinoKeyFromString(rhinoPointGuid);
+		if (rhinoKey == APINULLGuid) {
 			return APINULLGuid;
 		}
 		
-		API_Guid* foundGuid = g_rhinoToHotspotMap.GetPtr(rhinoPointGuid);
-		if (foundGuid != nullptr && *foundGuid != APINULLGuid) {
-			// Verify hotspot still exists
-			API_Element hotspot = {};
-			hotspot.header.guid = *foundGuid;
-			if (ACAPI_Element_Get(&hotspot) == NoError && hotspot.header.type == API_HotspotID) {
-				return *foundGuid;
-			} else {
-				// Hotspot was deleted, remove from map
-				g_rhinoToHotspotMap.Delete(rhinoPointGuid);
-				return APINULLGuid;
-			}
+		const API_Guid* foundGuid = g_rhinoToHotspotMap.GetPtr(rhinoKey);
+		if (foundGuid == nullptr) {
+			return APINULLGuid;
 		}
+		
+		// Verify hotspot still exists (in-memory, kept up to date by notifications)
+		const API_Guid hotspotGuid = *foundGuid;
+		if (ElementTracker::IsAlive(hotspotGuid, API_HotspotID)) {
+			return hotspotGuid;
+		}
+		
+		// Hotspot was deleted, remove from tracking
+		RemoveHotspot(hotspotGuid);
 		return APINULLGuid;
 	}
 	
+	// Find rhinoPointGuid key the hotspot was created for
+	API_Guid FindRhinoKeyByHotspot(const API_Guid& hotspotGuid)
+	{
+		TrackingStore::EnsureLoaded();
+		const API_Guid* rhinoKey = g_hotspotToRhinoMap.GetPtr(hotspotGuid);
+		return (rhinoKey != nullptr) ? *rhinoKey : APINULLGuid;
+	}
+	
 	GS::Array<API_Guid> GetAllHotspots()
 	{
-		return g_createdHotspots;
+		TrackingStore::EnsureLoaded();
+		GS::Array<API_Guid> hotspots;
+		hotspots.SetCapacity(g_createdHotspots.GetSize());
+		for (const API_Guid& hotspotGuid : g_createdHotspots) {
+			hotspots.Push(hotspotGuid);
+		}
+		return hotspots;
 	}
 	
 	void ClearAllHotspots()
 	{
+		for (const API_Guid& hotspotGuid : g_createdHotspots) {
+			ElementTracker::Untrack(hotspotGuid);
+			DimensionSets::ForgetHotspot(hotspotGuid);
+		}
 		g_createdHotspots.Clear();
 		g_rhinoToHotspotMap.Clear();
+		g_hotspotToRhinoMap.Clear();
+		TrackingStore::MarkAllDirty();
 	}
 	
 	void DeleteAllTrackedHotspots()
 	{
+		TrackingStore::EnsureLoaded();
 		if (g_createdHotspots.IsEmpty()) {
 			return;
 		}
 		// ACAPI_Element_Delete requires GS::Array<API_Guid>
-		ACAPI_Element_Delete(g_createdHotspots);
-		g_createdHotspots.Clear();
-		g_rhinoToHotspotMap.Clear();
+		ACAPI_Element_Delete(GetAllHotspots());
+		ClearAllHotspots();
 	}
 }
 
-// =============================================================================
-// DimensionManager - track created dimensions to avoid duplicates
-// Forward declaration - implementation is after CreateLinearDimensionCommand
-// =============================================================================
-
-namespace DimensionManager {
-	API_Guid FindExistingDimension(const API_Guid& hotspot1, const API_Guid& hotspot2);
-	void AddDimension(const API_Guid& hotspot1, const API_Guid& hotspot2, const API_Guid& dimensionGuid);
-}
-
 // =============================================================================
 // DimensionManager implementation
 // =============================================================================
 
 namespace DimensionManager {
-	// Structure to store hotspot pair and corresponding dimension GUID
-	struct HotspotPair {
+	// Order-normalized hotspot pair: (a, b) and (b, a) give the same 32-byte key
+	struct HotspotPairKey {
 		API_Guid hotspot1;
 		API_Guid hotspot2;
-		
-		bool operator==(const HotspotPair& other) const {
-			return (hotspot1 == other.hotspot1 && hotspot2 == other.hotspot2) ||
-			       (hotspot1 == other.hotspot2 && hotspot2 == other.hotspot1); // Order doesn't matter
+
+		HotspotPairKey() : hotspot1(APINULLGuid), hotspot2(APINULLGuid) {}
+		HotspotPairKey(const API_Guid& a, const API_Guid& b)
+		{
+			const bool swap = memcmp(&a, &b, sizeof(API_Guid)) > 0;
+			hotspot1 = swap ? b : a;
+			hotspot2 = swap ? a : b;
+		}
+
+		bool operator==(const HotspotPairKey& other) const
+		{
+			return memcmp(this, &other, sizeof(HotspotPairKey)) == 0;
+		}
+
+		ULong GenerateHashValue() const
+		{
+			UInt64 words[4];
+			static_assert(sizeof(words) == sizeof(HotspotPairKey), "HotspotPairKey must be 32 bytes");
+			memcpy(words, this, sizeof(words));
+			UInt64 hash = words[0] * 0x9E3779B97F4A7C15ULL;
+			hash = (hash ^ words[1]) * 0xC2B2AE3D27D4EB4FULL;
+			hash = (hash ^ words[2]) * 0x165667B19E3779F9ULL;
+			hash = (hash ^ words[3]) * 0x9E3779B97F4A7C15ULL;
+			return (ULong)(hash ^ (hash >> 32));
 		}
 	};
-	
-	static GS::Array<HotspotPair> g_dimensionPairs;
-	static GS::Array<API_Guid> g_dimensionGuids;
-	
+
+	// Node sequence of a dimension chain, direction-normalized like HotspotPairKey
+	struct HotspotChainKey {
+		GS::Array<API_Guid> hotspots;
+
+		HotspotChainKey() {}
+		explicit HotspotChainKey(const GS::Array<API_Guid>& nodes) : hotspots(nodes)
+		{
+			// (a, b, c) and (c, b, a) describe the same chain
+			const UInt32 count = hotspots.GetSize();
+			for (UInt32 i = 0; i < count / 2; ++i) {
+				const int order = memcmp(&hotspots[i], &hotspots[count - 1 - i], sizeof(API_Guid));
+				if (order == 0) {
+					continue;
+				}
+				if (order > 0) {
+					for (UInt32 j = 0; j < count / 2; ++j) {
+						const API_Guid tmp = hotspots[j];
+						hotspots[j] = hotspots[count - 1 - j];
+						hotspots[count - 1 - j] = tmp;
+					}
+				}
+				break;
+			}
+		}
+
+		bool operator==(const HotspotChainKey& other) const
+		{
+			return hotspots.GetSize() == other.hotspots.GetSize() &&
+				(hotspots.IsEmpty() || memcmp(hotspots.GetContent(), other.hotspots.GetContent(), hotspots.GetSize() * sizeof(API_Guid)) == 0);
+		}
+
+		ULong GenerateHashValue() const
+		{
+			UInt64 hash = 0xCBF29CE484222325ULL ^ hotspots.GetSize();
+			for (const API_Guid& guid : hotspots) {
+				UInt64 words[2];
+				memcpy(words, &guid, sizeof(words));
+				hash = (hash ^ words[0]) * 0x9E3779B97F4A7C15ULL;
+				hash = (hash ^ words[1]) * 0xC2B2AE3D27D4EB4FULL;
+			}
+			return (ULong)(hash ^ (hash >> 32));
+		}
+	};
+
+	// pair -> dimension, dimension -> pair, hotspot -> dimensions attached to it
+	static GS::HashTable<HotspotPairKey, API_Guid> g_pairToDimension;
+	static GS::HashTable<API_Guid, HotspotPairKey> g_dimensionToPair;
+	static GS::HashTable<API_Guid, GS::Array<API_Guid>> g_hotspotToDimensions;
+
+	// chain -> dimension, dimension -> chain (dimensions with more than two nodes)
+	static GS::HashTable<HotspotChainKey, API_Guid> g_chainToDimension;
+	static GS::HashTable<API_Guid, HotspotChainKey> g_dimensionToChain;
+
+	static void LinkToHotspot(const API_Guid& hotspotGuid, const API_Guid& dimensionGuid)
+	{
+		GS::Array<API_Guid>* dimensions = g_hotspotToDimensions.GetPtr(hotspotGuid);
+		if (dimensions == nullptr) {
+			g_hotspotToDimensions.Add(hotspotGuid, GS::Array<API_Guid> ());
+			dimensions = g_hotspotToDimensions.GetPtr(hotspotGuid);
+		}
+		if (!dimensions->Contains(dimensionGuid)) {
+			dimensions->Push(dimensionGuid);
+		}
+	}
+
+	static void UnlinkFromHotspot(const API_Guid& hotspotGuid, const API_Guid& dimensionGuid)
+	{
+		GS::Array<API_Guid>* dimensions = g_hotspotToDimensions.GetPtr(hotspotGuid);
+		if (dimensions == nullptr) {
+			return;
+		}
+		for (UIndex i = 0; i < dimensions->GetSize(); ++i) {
+			if ((*dimensions)[i] == dimensionGuid) {
+				// Order of dimensions per hotspot is irrelevant - swap with last
+				(*dimensions)[i] = dimensions->GetLast();
+				dimensions->DeleteLast();
+				break;
+			}
+		}
+		if (dimensions->IsEmpty()) {
+			g_hotspotToDimensions.Delete(hotspotGuid);
+			HotspotSweeper::MarkCandidate(hotspotGuid);
+		}
+	}
+
 	// Check if dimension already exists for this hotspot pair
 	API_Guid FindExistingDimension(const API_Guid& hotspot1, const API_Guid& hotspot2)
 	{
+		TrackingStore::EnsureLoaded();
 		if (hotspot1 == APINULLGuid || hotspot2 == APINULLGuid) {
 			return APINULLGuid;
 		}
-		
-		HotspotPair pair = {hotspot1, hotspot2};
-		for (UIndex i = 0; i < g_dimensionPairs.GetSize(); ++i) {
-			if (g_dimensionPairs[i] == pair) {
-				// Check if dimension still exists
-				API_Element dim = {};
-				dim.header.guid = g_dimensionGuids[i];
-				if (ACAPI_Element_Get(&dim) == NoError && dim.header.type == API_DimensionID) {
-					return g_dimensionGuids[i];
-				} else {
-					// Dimension was deleted, remove from tracking
-					g_dimensionPairs.Delete(i);
-					g_dimensionGuids.Delete(i);
-					return APINULLGuid;
-				}
-			}
+
+		const API_Guid* dimensionGuid = g_pairToDimension.GetPtr(HotspotPairKey(hotspot1, hotspot2));
+		if (dimensionGuid == nullptr) {
+			return APINULLGuid;
+		}
+
+		// Check if dimension still exists (in-memory, kept up to date by notifications)
+		if (ElementTracker::IsAlive(*dimensionGuid, API_DimensionID)) {
+			return *dimensionGuid;
 		}
+
+		// Dimension was deleted, remove from tracking
+		const API_Guid deletedGuid = *dimensionGuid;
+		RemoveDimension(deletedGuid);
 		return APINULLGuid;
 	}
-	
+
 	// Register a new dimension for hotspot pair
 	void AddDimension(const API_Guid& hotspot1, const API_Guid& hotspot2, const API_Guid& dimensionGuid)
 	{
 		if (hotspot1 == APINULLGuid || hotspot2 == APINULLGuid || dimensionGuid == APINULLGuid) {
 			return;
 		}
-		
-		// Check if already exists
-		if (FindExistingDimension(hotspot1, hotspot2) != APINULLGuid) {
+
+		TrackingStore::EnsureLoaded();
+		const HotspotPairKey key(hotspot1, hotspot2);
+		if (g_pairToDimension.ContainsKey(key)) {
 			return; // Already tracked
 		}
-		
-		HotspotPair pair = {hotspot1, hotspot2};
-		g_dimensionPairs.Push(pair);
-		g_dimensionGuids.Push(dimensionGuid);
+		TrackingStore::MarkDimensionDirty(dimensionGuid);
+
+		g_pairToDimension.Add(key, dimensionGuid);
+		g_dimensionToPair.Add(dimensionGuid, key);
+		ElementTracker::Track(dimensionGuid, API_DimensionID);
+
+		LinkToHotspot(key.hotspot1, dimensionGuid);
+		LinkToHotspot(key.hotspot2, dimensionGuid);
 	}
-	
-	// Clear all tracked dimensions
-	void ClearAllDimensions()
+
+	// Check if a chain dimension already exists for this node sequence (either direction)
+	API_Guid FindExistingChain(const GS::Array<API_Guid>& hotspots)
 	{
-		g_dimensionPairs.Clear();
-		g_dimensionGuids.Clear();
-	}
-}
+		TrackingStore::EnsureLoaded();
+		if (hotspots.GetSize() == 2) {
+			return FindExistingDimension(hotspots[0], hotspots[1]);
+		}
+		if (hotspots.GetSize() < 2 || hotspots.Contains(APINULLGuid)) {
+			return APINULLGuid;
+		}
 
-// =============================================================================
-// CreateHotspotCommand implementation
-// =============================================================================
+		const API_Guid* dimensionGuid = g_chainToDimension.GetPtr(HotspotChainKey(hotspots));
+		if (dimensionGuid == nullptr) {
+			return APINULLGuid;
+		}
 
-GS::String CreateHotspotCommand::GetName () const
-{
-	return "CreateHotspot";
-}
+		if (ElementTracker::IsAlive(*dimensionGuid, API_DimensionID)) {
+			return *dimensionGuid;
+		}
 
-GS::String CreateHotspotCommand::GetNamespace () const
-{
-	return "DimensionGh";
-}
+		const API_Guid deletedGuid = *dimensionGuid;
+		RemoveDimension(deletedGuid);
+		return APINULLGuid;
+	}
 
-GS::Optional<GS::UniString> CreateHotspotCommand::GetSchemaDefinitions () const
-{
-	return GS::NoValue;
-}
+	// Register a new chain dimension (two-node chains are tracked as pairs)
+	void AddDimensionChain(const GS::Array<API_Guid>& hotspots, const API_Guid& dimensionGuid)
+	{
+		if (hotspots.GetSize() == 2) {
+			AddDimension(hotspots[0], hotspots[1], dimensionGuid);
+			return;
+		}
+		if (hotspots.GetSize() < 2 || hotspots.Contains(APINULLGuid) || dimensionGuid == APINULLGuid) {
+			return;
+		}
 
-GS::Optional<GS::UniString> CreateHotspotCommand::GetInputParametersSchema () const
-{
-	return GS::NoValue;
-}
+		TrackingStore::EnsureLoaded();
+		const HotspotChainKey key(hotspots);
+		if (g_chainToDimension.ContainsKey(key)) {
+			return; // Already tracked
+		}
+		TrackingStore::MarkDimensionDirty(dimensionGuid);
 
-GS::Optional<GS::UniString> CreateHotspotCommand::GetResponseSchema () const
-{
-	return GS::NoValue;
-}
+		g_chainToDimension.Add(key, dimensionGuid);
+		g_dimensionToChain.Add(dimensionGuid, key);
+		ElementTracker::Track(dimensionGuid, API_DimensionID);
+
+		for (const API_Guid& hotspotGuid : key.hotspots) {
+			LinkToHotspot(hotspotGuid, dimensionGuid);
+		}
+	}
+
+	// Stop tracking a dimension(e.g. after it was deleted)
+	void RemoveDimension(const API_Guid& dimensionGuid)
+	{
+		TrackingStore::EnsureLoaded();
+		const HotspotChainKey* chainPtr = g_dimensionToChain.GetPtr(dimensionGuid);
+		if (chainPtr != nullptr) {
+			const HotspotChainKey chain = *chainPtr;
+			g_dimensionToChain.Delete(dimensionGuid);
+			g_chainToDimension.Delete(chain);
+			TrackingStore::MarkDimensionDirty(dimensionGuid);
+			ElementTracker::Untrack(dimensionGuid);
+			DimensionSets::ForgetDimension(dimensionGuid);
+			for (const API_Guid& hotspotGuid : chain.hotspots) {
+				UnlinkFromHotspot(hotspotGuid, dimensionGuid);
+			}
+			return;
+		}
+
+		const HotspotPairKey* keyPtr = g_dimensionToPair.GetPtr(dimensionGuid);
+		if (keyPtr == nullptr) {
+			return;
+		}
+		const HotspotPairKey key = *keyPtr;
+		g_dimensionToPair.Delete(dimensionGuid);
+		g_pairToDimension.Delete(key);
+		TrackingStore::MarkDimensionDirty(dimensionGuid);
+		ElementTracker::Untrack(dimensionGuid);
+		DimensionSets::ForgetDimension(dimensionGuid);
+		UnlinkFromHotspot(key.hotspot1, dimensionGuid);
+		UnlinkFromHotspot(key.hotspot2, dimensionGuid);
+	}
+
+	// All tracked dimensions (pairs and chains)
+	GS::Array<API_Guid> GetAllDimensions()
+	{
+		TrackingStore::EnsureLoaded();
+		GS::Array<API_Guid> dimensions;
+		dimensions.SetCapacity(g_dimensionToPair.GetSize() + g_dimensionToChain.GetSize());
+		for (auto it = g_dimensionToPair.Begin(); it != g_dimensionToPair.End(); ++it) {
+			dimensions.Push(it->key);
+		}
+		for (auto it = g_dimensionToChain.Begin(); it != g_dimensionToChain.End(); ++it) {
+			dimensions.Push(it->key);
+		}
+		return dimensions;
+	}
+
+	// Check if dimension is tracked by this add-on
+	bool IsTrackedDimension(const API_Guid& dimensionGuid)
+	{
+		TrackingStore::EnsureLoaded();
+		return g_dimensionToPair.ContainsKey(dimensionGuid) || g_dimensionToChain.ContainsKey(dimensionGuid);
+	}
+
+	// Dimensions attached to the given hotspot
+	GS::Array<API_Guid> GetDimensionsForHotspot(const API_Guid& hotspotGuid)
+	{
+		TrackingStore::EnsureLoaded();
+		const GS::Array<API_Guid>* dimensions = g_hotspotToDimensions.GetPtr(hotspotGuid);
+		return (dimensions != nullptr) ? *dimensions : GS::Array<API_Guid> ();
+	}
+
+	// Hotspots attached to the given dimension
+	GS::Array<API_Guid> GetHotspotsForDimension(const API_Guid& dimensionGuid)
+	{
+		TrackingStore::EnsureLoaded();
+		const HotspotChainKey* chain = g_dimensionToChain.GetPtr(dimensionGuid);
+		if (chain != nullptr) {
+			return chain->hotspots;
+		}
+		GS::Array<API_Guid> hotspots;
+		const HotspotPairKey* pair = g_dimensionToPair.GetPtr(dimensionGuid);
+		if (pair != nullptr) {
+			hotspots.Push(pair->hotspot1);
+			hotspots.Push(pair->hotspot2);
+		}
+		return hotspots;
+	}
+
+	// Live dimensions attached to the given hotspot (deleted ones stay linked until untracked, undo may restore them)
+	UInt32 GetReferenceCount(const API_Guid& hotspotGuid)
+	{
+		TrackingStore::EnsureLoaded();
+		const GS::Array<API_Guid>* dimensions = g_hotspotToDimensions.GetPtr(hotspotGuid);
+		if (dimensions == nullptr) {
+			return 0;
+		}
+		UInt32 count = 0;
+		for (const API_Guid& dimensionGuid : *dimensions) {
+			if (ElementTracker::IsAlive(dimensionGuid, API_DimensionID)) {
+				++count;
+			}
+		}
+		return count;
+	}
+
+	// Clear all tracked dimensions
+	void ClearAllDimensions()
+	{
+		for (auto it = g_dimensionToPair.Begin(); it != g_dimensionToPair.End(); ++it) {
+			ElementTracker::Untrack(it->key);
+			DimensionSets::ForgetDimension(it->key);
+		}
+		for (auto it = g_dimensionToChain.Begin(); it != g_dimensionToChain.End(); ++it) {
+			ElementTracker::Untrack(it->key);
+			DimensionSets::ForgetDimension(it->key);
+		}
+		g_pairToDimension.Clear();
+		g_dimensionToPair.Clear();
+		g_chainToDimension.Clear();
+		g_dimensionToChain.Clear();
+		g_hotspotToDimensions.Clear();
+		TrackingStore::MarkAllDirty();
+	}
+}
+
+// =============================================================================
+// CreateHotspotCommand implementation
+// =============================================================================
+
+GS::String CreateHotspotCommand::GetName () const
+{
+	return "CreateHotspot";
+}
+
+GS::String CreateHotspotCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> CreateHotspotCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CreateHotspotCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CreateHotspotCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
 
 GS::ObjectState CreateHotspotCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
 {
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording()) {
+		return UndoSession::Enqueue(*this, parameters);
+	}
+
 	// Extract coordinates and optional rhinoPointGuid
 	API_Coord coord = {};
 	bool hasCoord = false;
@@ -652,11 +1240,13 @@ GS::ObjectState CreateHotspotCommand::Execute (const GS::ObjectState& parameters
 				ACAPI_ELEMENT_MASK_CLEAR(mask);
 				ACAPI_ELEMENT_MASK_SET(mask, API_HotspotType, pos);
 				
-				GSErrCode err = ACAPI_CallUndoableCommand("UpdateHotspot", [&]() -> GSErrCode {
+				GSErrCode err = UndoSession::RunUndoable("UpdateHotspot", [&]() -> GSErrCode {
 					return ACAPI_Element_Change(&hotspot, &mask, nullptr, 0, true);
 				});
 				
 				if (err == NoError) {
+					SpatialIndex::SetHotspot(existingHotspotGuid, coord);
+					ChangeFeed::Record(ChangeFeed::ChangeKind::Modified, existingHotspotGuid, API_HotspotID, &coord);
 					GS::ObjectState response;
 					response.Add("success", true);
 					GS::UniString hotspotGuidStr = APIGuidToString(existingHotspotGuid);
@@ -669,22 +1259,14 @@ GS::ObjectState CreateHotspotCommand::Execute (const GS::ObjectState& parameters
 		}
 	}
 
-	// Try to find nearest element by coordinate (optional - hotspot can exist without element)
+	// Try to find element under the point (optional - hotspot can exist without element)
 	API_Guid elementGuid = APINULLGuid;
-	API_ElemSearchPars searchPars = {};
-	searchPars.type = API_ZombieElemID;  // Search for any element
-	searchPars.loc.x = coord.x;
-	searchPars.loc.y = coord.y;
-	searchPars.z = 1.00E6;  // Large Z range
-	searchPars.filterBits = APIFilt_OnVisLayer | APIFilt_OnActFloor;
-
-	GSErrCode err = ACAPI_Element_SearchElementByCoord(&searchPars, &elementGuid);
+	SpatialIndex::FindElementAt(coord, elementGuid);
 	// Note: We continue even if no element is found - hotspot can be created standalone
 
 	// Create hotspot element
-	API_Element hotspot = {};
-	hotspot.header.type = API_HotspotID;
-	err = ACAPI_Element_GetDefaults(&hotspot, nullptr);
+	API_Element hotspot;
+	GSErrCode err = DefaultsCache::GetDefaults(API_HotspotID, hotspot);
 	if (err != NoError) {
 		GS::ObjectState response;
 		response.Add("success", false);
@@ -700,8 +1282,14 @@ GS::ObjectState CreateHotspotCommand::Execute (const GS::ObjectState& parameters
 	// Note: API_Coord is 2D only, no z coordinate
 
 	// Create hotspot
-	err = ACAPI_CallUndoableCommand("CreateHotspot", [&]() -> GSErrCode {
-		return ACAPI_Element_Create(&hotspot, nullptr);
+	err = UndoSession::RunUndoable("CreateHotspot", [&]() -> GSErrCode {
+		GSErrCode createErr = ACAPI_Element_Create(&hotspot, nullptr);
+		if (createErr == NoError) {
+			SpatialIndex::SetHotspot(hotspot.header.guid, coord);
+			// Track the created hotspot with rhinoPointGuid mapping
+			HotspotManager::AddHotspot(hotspot.header.guid, rhinoPointGuid);
+		}
+		return createErr;
 	});
 
 	if (err != NoError) {
@@ -714,9 +1302,6 @@ GS::ObjectState CreateHotspotCommand::Execute (const GS::ObjectState& parameters
 		return response;
 	}
 
-	// Track the created hotspot with rhinoPointGuid mapping
-	HotspotManager::AddHotspot(hotspot.header.guid, rhinoPointGuid);
-
 	// Return success with hotspot GUID and optional element GUID
 	GS::ObjectState response;
 	response.Add("success", true);
@@ -767,6 +1352,11 @@ GS::Optional<GS::UniString> UpdateHotspotCommand::GetResponseSchema () const
 
 GS::ObjectState UpdateHotspotCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
 {
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording()) {
+		return UndoSession::Enqueue(*this, parameters);
+	}
+
 	// Extract hotspot GUID and new coordinates
 	GS::UniString hotspotGuidStr;
 	API_Coord newCoord = {};
@@ -819,6 +1409,27 @@ GS::ObjectState UpdateHotspotCommand::Execute (const GS::ObjectState& parameters
 		return response;
 	}
 
+	// Live-drag mode: only the latest position is kept, written by the next frame flush
+	if (LiveDrag::IsEnabled()) {
+		if (!ElementTracker::IsAlive(hotspotGuid, API_HotspotID)) {
+			GS::ObjectState response;
+			response.Add("success", false);
+			GS::ObjectState errorOS;
+			errorOS.Add("code", -4);
+			errorOS.Add("message", "Hotspot not found");
+			response.Add("error", errorOS);
+			return response;
+		}
+		const bool flushed = LiveDrag::Submit(hotspotGuid, newCoord);
+		GS::ObjectState response;
+		response.Add("success", true);
+		response.Add("coalesced", true);
+		response.Add("flushed", flushed);
+		response.Add("pendingCount", (Int32)LiveDrag::GetPendingCount());
+		response.Add("nextFlushInMs", (Int32)LiveDrag::GetMillisecondsToNextFlush());
+		return response;
+	}
+
 	// Get hotspot element
 	API_Element hotspot = {};
 	hotspot.header.guid = hotspotGuid;
@@ -843,7 +1454,7 @@ GS::ObjectState UpdateHotspotCommand::Execute (const GS::ObjectState& parameters
 	ACAPI_ELEMENT_MASK_CLEAR(mask);
 	ACAPI_ELEMENT_MASK_SET(mask, API_HotspotType, pos);  // pos is the field name in API_HotspotType
 
-	err = ACAPI_CallUndoableCommand("UpdateHotspot", [&]() -> GSErrCode {
+	err = UndoSession::RunUndoable("UpdateHotspot", [&]() -> GSErrCode {
 		return ACAPI_Element_Change(&hotspot, &mask, nullptr, 0, true);
 	});
 
@@ -857,6 +1468,9 @@ GS::ObjectState UpdateHotspotCommand::Execute (const GS::ObjectState& parameters
 		return response;
 	}
 
+	SpatialIndex::SetHotspot(hotspotGuid, newCoord);
+	ChangeFeed::Record(ChangeFeed::ChangeKind::Modified, hotspotGuid, API_HotspotID, &newCoord);
+
 	GS::ObjectState response;
 	response.Add("success", true);
 	return response;
@@ -897,6 +1511,11 @@ GS::Optional<GS::UniString> DeleteHotspotCommand::GetResponseSchema () const
 
 GS::ObjectState DeleteHotspotCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
 {
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording()) {
+		return UndoSession::Enqueue(*this, parameters);
+	}
+
 	GS::UniString hotspotGuidStr;
 	if (!parameters.Contains("hotspotGuid") || !parameters.Get("hotspotGuid", hotspotGuidStr) || hotspotGuidStr.IsEmpty()) {
 		GS::ObjectState response;
@@ -936,8 +1555,13 @@ GS::ObjectState DeleteHotspotCommand::Execute (const GS::ObjectState& parameters
 	// Delete hotspot - ACAPI_Element_Delete requires GS::Array<API_Guid>
 	GS::Array<API_Guid> guidsToDelete;
 	guidsToDelete.Push(hotspotGuid);
-	err = ACAPI_CallUndoableCommand("DeleteHotspot", [&]() -> GSErrCode {
-		return ACAPI_Element_Delete(guidsToDelete);
+	err = UndoSession::RunUndoable("DeleteHotspot", [&]() -> GSErrCode {
+		GSErrCode deleteErr = ACAPI_Element_Delete(guidsToDelete);
+		if (deleteErr == NoError) {
+			// Remove from tracking
+			HotspotManager::RemoveHotspot(hotspotGuid);
+		}
+		return deleteErr;
 	});
 
 	if (err != NoError) {
@@ -950,9 +1574,6 @@ GS::ObjectState DeleteHotspotCommand::Execute (const GS::ObjectState& parameters
 		return response;
 	}
 
-	// Remove from tracking
-	HotspotManager::RemoveHotspot(hotspotGuid);
-
 	GS::ObjectState response;
 	response.Add("success", true);
 	return response;
@@ -991,10 +1612,18 @@ GS::Optional<GS::UniString> DeleteAllHotspotsCommand::GetResponseSchema () const
 	return GS::NoValue;
 }
 
-GS::ObjectState DeleteAllHotspotsCommand::Execute (const GS::ObjectState& /*parameters*/, GS::ProcessControl& /*processControl*/) const
+GS::ObjectState DeleteAllHotspotsCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
 {
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
 	// Delete all tracked hotspots
-	HotspotManager::DeleteAllTrackedHotspots();
+	UndoSession::RunUndoable("DeleteAllHotspots", [&]() -> GSErrCode {
+		HotspotManager::DeleteAllTrackedHotspots();
+		return NoError;
+	});
 
 	GS::ObjectState response;
 	response.Add("success", true);
@@ -1006,3 +1635,1873 @@ void DeleteAllHotspotsCommand::OnResponseValidationFailed (const GS::ObjectState
 {
 }
 
+// =============================================================================
+// CreateLinearDimensionsCommand implementation (batch)
+// =============================================================================
+
+namespace {
+	struct LinearDimensionItem {
+		API_Coord		pt1 = {};
+		API_Coord		pt2 = {};
+		GS::UniString	rhinoPointGuid1;
+		GS::UniString	rhinoPointGuid2;
+		double			offset = 0.0;
+		Int32			errorCode = 0;		// 0 - valid input / created, < 0 - failed
+
+		DimensionHelper::LinePlacement	placement;
+
+		API_Guid		hotspotGuid1 = APINULLGuid;
+		API_Guid		hotspotGuid2 = APINULLGuid;
+		API_Guid		dimensionGuid = APINULLGuid;
+		bool			dimensionExisted = false;
+	};
+
+	GS::ObjectState MakeErrorResponse (Int32 code, const char* message)
+	{
+		GS::ObjectState response;
+		response.Add ("success", false);
+		GS::ObjectState errorOS;
+		errorOS.Add ("code", code);
+		errorOS.Add ("message", message);
+		response.Add ("error", errorOS);
+		return response;
+	}
+
+	// Optional named set the created elements belong to ("componentId" is the older name)
+	bool GetSetIdFromObjectState (const GS::ObjectState& os, GS::UniString& setId)
+	{
+		if (os.Contains ("setId")) {
+			os.Get ("setId", setId);
+		} else if (os.Contains ("componentId")) {
+			os.Get ("componentId", setId);
+		}
+		return !setId.IsEmpty ();
+	}
+
+	bool GetCoordFromObjectState (const GS::ObjectState& os, const char* key, API_Coord& coord)
+	{
+		GS::ObjectState pointObj;
+		if (!os.Contains (key) || !os.Get (key, pointObj)) {
+			return false;
+		}
+		double x = 0.0, y = 0.0;
+		if (!pointObj.Get ("x", x) || !pointObj.Get ("y", y)) {
+			return false;
+		}
+		coord.x = x;
+		coord.y = y;
+		return true;
+	}
+
+	// Decode pairs [begin, end) - { point1, point2, rhinoPointGuid1, rhinoPointGuid2, offset } - and place their base lines
+	// No ACAPI calls - runs on BatchPipeline workers; requireIdentity rejects pairs without both Rhino point GUIDs
+	void DecodeLinearDimensionItems (const GS::Array<GS::ObjectState>& pairs, UInt32 begin, UInt32 end, bool requireIdentity,
+									 GS::Array<LinearDimensionItem>& items)
+	{
+		const UInt32 count = end - begin;
+		std::vector<double> inputs (5 * count, 0.0);
+		double* x1 = inputs.data ();
+		double* y1 = x1 + count;
+		double* x2 = y1 + count;
+		double* y2 = x2 + count;
+		double* offsets = y2 + count;
+
+		for (UInt32 i = 0; i < count; ++i) {
+			const GS::ObjectState& pairOS = pairs[begin + i];
+			LinearDimensionItem& item = items[begin + i];
+			if (!GetCoordFromObjectState (pairOS, "point1", item.pt1) || !GetCoordFromObjectState (pairOS, "point2", item.pt2)) {
+				item.errorCode = -1;
+			}
+			if (pairOS.Contains ("rhinoPointGuid1")) {
+				pairOS.Get ("rhinoPointGuid1", item.rhinoPointGuid1);
+			}
+			if (pairOS.Contains ("rhinoPointGuid2")) {
+				pairOS.Get ("rhinoPointGuid2", item.rhinoPointGuid2);
+			}
+			if (pairOS.Contains ("offset")) {
+				pairOS.Get ("offset", item.offset);
+			}
+			x1[i] = item.pt1.x;
+			y1[i] = item.pt1.y;
+			x2[i] = item.pt2.x;
+			y2[i] = item.pt2.y;
+			offsets[i] = item.offset;
+		}
+
+		// The whole block goes through the SIMD kernel at once
+		std::vector<double> outputs (7 * count);
+		std::vector<unsigned char> degenerate (count);
+		PlacementKernel::LineInputs in;
+		in.x1 = x1;
+		in.y1 = y1;
+		in.x2 = x2;
+		in.y2 = y2;
+		in.offset = offsets;
+		PlacementKernel::LinePlacements out;
+		out.dirX = outputs.data ();
+		out.dirY = out.dirX + count;
+		out.perpX = out.dirY + count;
+		out.perpY = out.perpX + count;
+		out.refX = out.perpY + count;
+		out.refY = out.refX + count;
+		out.length = out.refY + count;
+		out.degenerate = degenerate.data ();
+		PlacementKernel::ComputePlacements (in, out, count);
+
+		for (UInt32 i = 0; i < count; ++i) {
+			LinearDimensionItem& item = items[begin + i];
+			item.placement.refC.x = out.refX[i];
+			item.placement.refC.y = out.refY[i];
+			item.placement.direction.x = out.dirX[i];
+			item.placement.direction.y = out.dirY[i];
+			item.placement.length = out.length[i];
+			item.placement.degenerate = (degenerate[i] != 0);
+			if (item.errorCode == 0 && item.placement.degenerate) {
+				item.errorCode = -2;
+			}
+			if (requireIdentity && (item.rhinoPointGuid1.IsEmpty () || item.rhinoPointGuid2.IsEmpty ())) {
+				// Identity is what makes the diff possible
+				item.errorCode = -4;
+			}
+		}
+	}
+
+	enum class HotspotUpsert {
+		Unchanged,
+		Moved,
+		Created
+	};
+
+	// True if the hotspot exists and is within moveEpsilon of coord (position cache, no database read)
+	bool IsHotspotAt (const API_Guid& hotspotGuid, const API_Coord& coord, double moveEpsilon)
+	{
+		API_Coord currentPos = {};
+		if (!SpatialIndex::GetHotspotPosition (hotspotGuid, currentPos)) {
+			return false;
+		}
+		const double dx = currentPos.x - coord.x;
+		const double dy = currentPos.y - coord.y;
+		return dx * dx + dy * dy <= moveEpsilon * moveEpsilon;
+	}
+
+	// Create a hotspot, or move the one already tracked for rhinoPointGuid
+	// Moves up to moveEpsilon are skipped; unchanged hotspots cost no database read
+	// Must be called from inside UndoSession::RunUndoable
+	GSErrCode UpsertHotspotInUndoScope (const API_Coord& coord, const GS::UniString& rhinoPointGuid, API_Guid& hotspotGuid, HotspotUpsert* outcome = nullptr, double moveEpsilon = 0.0)
+	{
+		hotspotGuid = HotspotManager::FindHotspotByRhinoGuid (rhinoPointGuid);
+		if (hotspotGuid != APINULLGuid) {
+			if (IsHotspotAt (hotspotGuid, coord, moveEpsilon)) {
+				if (outcome != nullptr) {
+					*outcome = HotspotUpsert::Unchanged;
+				}
+				return NoError;
+			}
+
+			API_Element hotspot = {};
+			hotspot.header.guid = hotspotGuid;
+			GSErrCode err = ACAPI_Element_Get (&hotspot);
+			if (err != NoError) {
+				return err;
+			}
+			hotspot.hotspot.pos.x = coord.x;
+			hotspot.hotspot.pos.y = coord.y;
+
+			API_Element mask = {};
+			ACAPI_ELEMENT_MASK_CLEAR (mask);
+			ACAPI_ELEMENT_MASK_SET (mask, API_HotspotType, pos);
+			err = ACAPI_Element_Change (&hotspot, &mask, nullptr, 0, true);
+			if (err == NoError) {
+				SpatialIndex::SetHotspot (hotspotGuid, coord);
+				ChangeFeed::Record (ChangeFeed::ChangeKind::Modified, hotspotGuid, API_HotspotID, &coord);
+				if (outcome != nullptr) {
+					*outcome = HotspotUpsert::Moved;
+				}
+			}
+			return err;
+		}
+
+		API_Element hotspot;
+		GSErrCode err = DefaultsCache::GetDefaults (API_HotspotID, hotspot);
+		if (err != NoError) {
+			return err;
+		}
+		hotspot.hotspot.pos.x = coord.x;
+		hotspot.hotspot.pos.y = coord.y;
+
+		err = ACAPI_Element_Create (&hotspot, nullptr);
+		if (err != NoError) {
+			return err;
+		}
+		hotspotGuid = hotspot.header.guid;
+		SpatialIndex::SetHotspot (hotspotGuid, coord);
+		HotspotManager::AddHotspot (hotspotGuid, rhinoPointGuid);
+		if (outcome != nullptr) {
+			*outcome = HotspotUpsert::Created;
+		}
+		return NoError;
+	}
+}
+
+GS::String CreateLinearDimensionsCommand::GetName () const
+{
+	return "CreateLinearDimensions";
+}
+
+GS::String CreateLinearDimensionsCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> CreateLinearDimensionsCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CreateLinearDimensionsCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CreateLinearDimensionsCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "pairs": [ { "point1": {x,y}, "point2": {x,y}, "rhinoPointGuid1", "rhinoPointGuid2", "offset" }, ... ], "setId" }
+//         with "setId" the hotspots and dimensions are added to that named set
+// Output: { "success", "createdCount", "existingCount", "failedCount",
+//           "results": [ { "hotspotGuid1", "hotspotGuid2", "dimensionGuid" } | { "error": code }, ... ] }
+GS::ObjectState CreateLinearDimensionsCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const
+{
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
+	GS::Array<GS::ObjectState> pairs;
+	if (!parameters.Contains ("pairs") || !parameters.Get ("pairs", pairs)) {
+		GS::ObjectState response;
+		response.Add ("success", false);
+		GS::ObjectState errorOS;
+		errorOS.Add ("code", -1);
+		errorOS.Add ("message", "Missing or invalid 'pairs' array");
+		response.Add ("error", errorOS);
+		return response;
+	}
+
+	// Items are decoded on worker threads while the main thread already writes the ones before them
+	GS::Array<LinearDimensionItem> items;
+	items.SetSize (pairs.GetSize ());
+
+	GS::UniString setId;
+	const bool hasSet = GetSetIdFromObjectState (parameters, setId);
+
+	// All hotspot and dimension upserts share a single undo step
+	GSErrCode err = UndoSession::RunUndoable ("CreateLinearDimensions", [&]() -> GSErrCode {
+		// Every dimension of the batch has two nodes - one node handle for all of them
+		DimensionHelper::DimElemPool dimElemPool (2);
+		auto decode = [&] (UInt32 begin, UInt32 end) {
+			DecodeLinearDimensionItems (pairs, begin, end, false, items);
+		};
+		const UInt32 consumedCount = BatchPipeline::Run (items.GetSize (), decode, [&] (UInt32 index) -> bool {
+			LinearDimensionItem& item = items[index];
+			if (item.errorCode != 0) {
+				return true;
+			}
+			if (processControl.IsBreaked ()) {
+				item.errorCode = -6;		// cancelled in Archicad
+				return false;
+			}
+			if (UpsertHotspotInUndoScope (item.pt1, item.rhinoPointGuid1, item.hotspotGuid1) != NoError ||
+				UpsertHotspotInUndoScope (item.pt2, item.rhinoPointGuid2, item.hotspotGuid2) != NoError) {
+				item.errorCode = -5;
+				return true;
+			}
+
+			item.dimensionGuid = DimensionManager::FindExistingDimension (item.hotspotGuid1, item.hotspotGuid2);
+			if (item.dimensionGuid != APINULLGuid) {
+				// Dimension follows its hotspots - nothing to do
+				item.dimensionExisted = true;
+				return true;
+			}
+
+			if (!DimensionHelper::CreateLinearDimensionInUndoScope (item.pt1, item.pt2, &item.dimensionGuid, &item.hotspotGuid1, &item.hotspotGuid2,
+																	nullptr, nullptr, GS::EmptyUniString, GS::EmptyUniString, GS::EmptyUniString, item.offset,
+																	DimensionHelper::DefaultSnapTolerance, &item.placement)) {
+				item.errorCode = -3;
+				return true;
+			}
+			DimensionManager::AddDimension (item.hotspotGuid1, item.hotspotGuid2, item.dimensionGuid);
+			return true;
+		});
+		// Items after a cancel are neither consumed nor (fully) decoded
+		for (UInt32 i = consumedCount; i < items.GetSize (); ++i) {
+			items[i].errorCode = -6;
+		}
+		if (hasSet) {
+			for (const LinearDimensionItem& item : items) {
+				if (item.errorCode == 0) {
+					DimensionSets::AddHotspot (setId, item.hotspotGuid1);
+					DimensionSets::AddHotspot (setId, item.hotspotGuid2);
+					DimensionSets::AddDimension (setId, item.dimensionGuid);
+				}
+			}
+		}
+		// Per-item failures are reported in results; keep what succeeded
+		return NoError;
+	});
+
+	GS::ObjectState response;
+	if (err != NoError) {
+		response.Add ("success", false);
+		GS::ObjectState errorOS;
+		errorOS.Add ("code", (Int32)err);
+		errorOS.Add ("message", "Failed to execute batch in Archicad");
+		response.Add ("error", errorOS);
+		return response;
+	}
+
+	Int32 createdCount = 0;
+	Int32 existingCount = 0;
+	Int32 failedCount = 0;
+	GS::Array<GS::ObjectState> results;
+	results.SetCapacity (items.GetSize ());
+	for (const LinearDimensionItem& item : items) {
+		GS::ObjectState resultOS;
+		if (item.errorCode != 0) {
+			resultOS.Add ("error", item.errorCode);
+			++failedCount;
+		} else {
+			resultOS.Add ("hotspotGuid1", APIGuidToString (item.hotspotGuid1));
+			resultOS.Add ("hotspotGuid2", APIGuidToString (item.hotspotGuid2));
+			resultOS.Add ("dimensionGuid", APIGuidToString (item.dimensionGuid));
+			if (item.dimensionExisted) {
+				++existingCount;
+			} else {
+				++createdCount;
+			}
+		}
+		results.Push (resultOS);
+	}
+
+	response.Add ("success", true);
+	response.Add ("createdCount", createdCount);
+	response.Add ("existingCount", existingCount);
+	response.Add ("failedCount", failedCount);
+	response.Add ("results", results);
+	return response;
+}
+
+void CreateLinearDimensionsCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+
+// =============================================================================
+// CreateDimensionChainCommand implementation
+// =============================================================================
+
+GS::String CreateDimensionChainCommand::GetName () const
+{
+	return "CreateDimensionChain";
+}
+
+GS::String CreateDimensionChainCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> CreateDimensionChainCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CreateDimensionChainCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CreateDimensionChainCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "points": [ { "x", "y", "rhinoPointGuid" }, ... ], "offset", "setId" }
+// Output: { "success", "dimensionGuid", "existed", "hotspotGuids": [ ... ] }
+GS::ObjectState CreateDimensionChainCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
+	GS::Array<GS::ObjectState> pointsOS;
+	if (!parameters.Contains ("points") || !parameters.Get ("points", pointsOS)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'points' array");
+	}
+	if (pointsOS.GetSize () < 2) {
+		return MakeErrorResponse (-1, "A dimension chain needs at least 2 points");
+	}
+
+	GS::Array<API_Coord> points;
+	GS::Array<GS::UniString> rhinoPointGuids;
+	points.SetCapacity (pointsOS.GetSize ());
+	rhinoPointGuids.SetCapacity (pointsOS.GetSize ());
+	for (const GS::ObjectState& pointOS : pointsOS) {
+		API_Coord coord = {};
+		if (!pointOS.Get ("x", coord.x) || !pointOS.Get ("y", coord.y)) {
+			return MakeErrorResponse (-1, "Missing or invalid point coordinates");
+		}
+		GS::UniString rhinoPointGuid;
+		if (pointOS.Contains ("rhinoPointGuid")) {
+			pointOS.Get ("rhinoPointGuid", rhinoPointGuid);
+		}
+		points.Push (coord);
+		rhinoPointGuids.Push (rhinoPointGuid);
+	}
+
+	const API_Coord& first = points[0];
+	const API_Coord& last = points[points.GetSize () - 1];
+	if (std::hypot (last.x - first.x, last.y - first.y) < 1e-6) {
+		return MakeErrorResponse (-2, "First and last points are too close (distance < 1e-6)");
+	}
+
+	double offset = 0.0;
+	if (parameters.Contains ("offset")) {
+		parameters.Get ("offset", offset);
+	}
+
+	GS::UniString setId;
+	const bool hasSet = GetSetIdFromObjectState (parameters, setId);
+
+	// Hotspots and the chain share a single undo step
+	GS::Array<API_Guid> hotspotGuids;
+	API_Guid dimensionGuid = APINULLGuid;
+	bool existed = false;
+	GSErrCode err = UndoSession::RunUndoable ("CreateDimensionChain", [&]() -> GSErrCode {
+		for (UIndex i = 0; i < points.GetSize (); ++i) {
+			API_Guid hotspotGuid = APINULLGuid;
+			GSErrCode hotspotErr = UpsertHotspotInUndoScope (points[i], rhinoPointGuids[i], hotspotGuid);
+			if (hotspotErr != NoError) {
+				return hotspotErr;
+			}
+			hotspotGuids.Push (hotspotGuid);
+		}
+
+		dimensionGuid = DimensionManager::FindExistingChain (hotspotGuids);
+		if (dimensionGuid != APINULLGuid) {
+			// Chain follows its hotspots - nothing to do
+			existed = true;
+		} else if (DimensionHelper::CreateDimensionChainInUndoScope (points, hotspotGuids, &dimensionGuid, offset)) {
+			DimensionManager::AddDimensionChain (hotspotGuids, dimensionGuid);
+		} else {
+			return APIERR_GENERAL;
+		}
+
+		if (hasSet) {
+			for (const API_Guid& hotspotGuid : hotspotGuids) {
+				DimensionSets::AddHotspot (setId, hotspotGuid);
+			}
+			DimensionSets::AddDimension (setId, dimensionGuid);
+		}
+		return NoError;
+	});
+
+	if (err != NoError) {
+		return MakeErrorResponse ((Int32)err, "Failed to create dimension chain in Archicad");
+	}
+
+	GS::Array<GS::UniString> hotspotGuidStrings;
+	hotspotGuidStrings.SetCapacity (hotspotGuids.GetSize ());
+	for (const API_Guid& hotspotGuid : hotspotGuids) {
+		hotspotGuidStrings.Push (APIGuidToString (hotspotGuid));
+	}
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("dimensionGuid", APIGuidToString (dimensionGuid));
+	response.Add ("existed", existed);
+	response.Add ("hotspotGuids", hotspotGuidStrings);
+	return response;
+}
+
+void CreateDimensionChainCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// SyncDimensionSetCommand implementation
+// =============================================================================
+
+GS::String SyncDimensionSetCommand::GetName () const
+{
+	return "SyncDimensionSet";
+}
+
+GS::String SyncDimensionSetCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> SyncDimensionSetCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> SyncDimensionSetCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> SyncDimensionSetCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "setId" (or "componentId"), "pairs": [ { "point1": {x,y}, "point2": {x,y}, "rhinoPointGuid1", "rhinoPointGuid2", "offset" }, ... ] }
+//         "pairs" is the complete desired content of the named set; whatever the set contained before
+//         and is no longer wanted is deleted (unless another set owns it too)
+// Output: { "success", "createdHotspots", "movedHotspots", "deletedHotspots", "createdDimensions",
+//           "deletedDimensions", "unchangedDimensions", "failedCount", "cancelled", "results": [ same as CreateLinearDimensions ] }
+// A cancelled sync keeps what it wrote so far and deletes nothing; the set then holds old and new members
+GS::ObjectState SyncDimensionSetCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const
+{
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
+	GS::UniString setId;
+	if (!GetSetIdFromObjectState (parameters, setId)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'setId'");
+	}
+
+	GS::Array<GS::ObjectState> pairs;
+	if (!parameters.Contains ("pairs") || !parameters.Get ("pairs", pairs)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'pairs' array");
+	}
+
+	// Items are decoded on worker threads while the main thread already writes the ones before them
+	GS::Array<LinearDimensionItem> items;
+	items.SetSize (pairs.GetSize ());
+
+	const DimensionSets::Members* previousPtr = DimensionSets::Get (setId);
+	const DimensionSets::Members previous = (previousPtr != nullptr) ? *previousPtr : DimensionSets::Members ();
+	DimensionSets::Members desired;
+
+	Int32 createdHotspots = 0;
+	Int32 movedHotspots = 0;
+	Int32 deletedHotspots = 0;
+	Int32 createdDimensions = 0;
+	Int32 deletedDimensions = 0;
+	Int32 unchangedDimensions = 0;
+	bool cancelled = false;
+
+	auto countHotspot = [&] (HotspotUpsert outcome) {
+		if (outcome == HotspotUpsert::Created) {
+			++createdHotspots;
+		} else if (outcome == HotspotUpsert::Moved) {
+			++movedHotspots;
+		}
+	};
+
+	// Creates, moves and deletes share a single undo step
+	GSErrCode err = UndoSession::RunUndoable ("SyncDimensionSet", [&]() -> GSErrCode {
+		// Every dimension of the batch has two nodes - one node handle for all of them
+		DimensionHelper::DimElemPool dimElemPool (2);
+		auto decode = [&] (UInt32 begin, UInt32 end) {
+			DecodeLinearDimensionItems (pairs, begin, end, true, items);
+		};
+		const UInt32 consumedCount = BatchPipeline::Run (items.GetSize (), decode, [&] (UInt32 index) -> bool {
+			LinearDimensionItem& item = items[index];
+			if (item.errorCode != 0) {
+				return true;
+			}
+			if (processControl.IsBreaked ()) {
+				item.errorCode = -6;		// cancelled in Archicad
+				cancelled = true;
+				return false;
+			}
+			HotspotUpsert outcome1 = HotspotUpsert::Unchanged;
+			HotspotUpsert outcome2 = HotspotUpsert::Unchanged;
+			if (UpsertHotspotInUndoScope (item.pt1, item.rhinoPointGuid1, item.hotspotGuid1, &outcome1) != NoError ||
+				UpsertHotspotInUndoScope (item.pt2, item.rhinoPointGuid2, item.hotspotGuid2, &outcome2) != NoError) {
+				item.errorCode = -5;
+				return true;
+			}
+			// A point shared by several pairs is moved by the first one only
+			if (!desired.hotspots.Contains (item.hotspotGuid1)) {
+				countHotspot (outcome1);
+				desired.hotspots.Add (item.hotspotGuid1);
+			}
+			if (!desired.hotspots.Contains (item.hotspotGuid2)) {
+				countHotspot (outcome2);
+				desired.hotspots.Add (item.hotspotGuid2);
+			}
+
+			item.dimensionGuid = DimensionManager::FindExistingDimension (item.hotspotGuid1, item.hotspotGuid2);
+			if (item.dimensionGuid != APINULLGuid) {
+				// Dimension follows its hotspots - nothing to do
+				item.dimensionExisted = true;
+				++unchangedDimensions;
+			} else if (DimensionHelper::CreateLinearDimensionInUndoScope (item.pt1, item.pt2, &item.dimensionGuid, &item.hotspotGuid1, &item.hotspotGuid2,
+																		   nullptr, nullptr, GS::EmptyUniString, GS::EmptyUniString, GS::EmptyUniString, item.offset,
+																		   DimensionHelper::DefaultSnapTolerance, &item.placement)) {
+				DimensionManager::AddDimension (item.hotspotGuid1, item.hotspotGuid2, item.dimensionGuid);
+				++createdDimensions;
+			} else {
+				item.errorCode = -3;
+				return true;
+			}
+			desired.dimensions.Add (item.dimensionGuid);
+			return true;
+		});
+		// Items after a cancel are neither consumed nor (fully) decoded
+		for (UInt32 i = consumedCount; i < items.GetSize (); ++i) {
+			items[i].errorCode = -6;
+		}
+
+		if (cancelled) {
+			// The desired set is incomplete - deleting against it would drop wanted elements
+			for (const API_Guid& hotspotGuid : previous.hotspots) {
+				desired.hotspots.Add (hotspotGuid);
+			}
+			for (const API_Guid& dimensionGuid : previous.dimensions) {
+				desired.dimensions.Add (dimensionGuid);
+			}
+			DimensionSets::Replace (setId, desired);
+			return NoError;
+		}
+
+		// Everything the previous sync produced and the desired set no longer contains
+		GS::Array<API_Guid> dimensionsToDelete;
+		for (const API_Guid& dimensionGuid : previous.dimensions) {
+			if (!desired.dimensions.Contains (dimensionGuid) && !DimensionSets::IsDimensionInOtherSet (setId, dimensionGuid) &&
+				ElementTracker::IsAlive (dimensionGuid, API_DimensionID)) {
+				dimensionsToDelete.Push (dimensionGuid);
+			}
+		}
+		GS::Array<API_Guid> hotspotsToDelete;
+		for (const API_Guid& hotspotGuid : previous.hotspots) {
+			if (!desired.hotspots.Contains (hotspotGuid) && !DimensionSets::IsHotspotInOtherSet (setId, hotspotGuid) &&
+				ElementTracker::IsAlive (hotspotGuid, API_HotspotID)) {
+				hotspotsToDelete.Push (hotspotGuid);
+				// Dimensions hanging on a removed hotspot go with it
+				for (const API_Guid& dimensionGuid : DimensionManager::GetDimensionsForHotspot (hotspotGuid)) {
+					if (!desired.dimensions.Contains (dimensionGuid) && !dimensionsToDelete.Contains (dimensionGuid) &&
+						!DimensionSets::IsDimensionInOtherSet (setId, dimensionGuid) &&
+						ElementTracker::IsAlive (dimensionGuid, API_DimensionID)) {
+						dimensionsToDelete.Push (dimensionGuid);
+					}
+				}
+			}
+		}
+
+		if (!dimensionsToDelete.IsEmpty ()) {
+			GSErrCode deleteErr = ACAPI_Element_Delete (dimensionsToDelete);
+			if (deleteErr != NoError) {
+				return deleteErr;
+			}
+			for (const API_Guid& dimensionGuid : dimensionsToDelete) {
+				DimensionManager::RemoveDimension (dimensionGuid);
+			}
+			deletedDimensions = (Int32)dimensionsToDelete.GetSize ();
+		}
+		if (!hotspotsToDelete.IsEmpty ()) {
+			GSErrCode deleteErr = ACAPI_Element_Delete (hotspotsToDelete);
+			if (deleteErr != NoError) {
+				return deleteErr;
+			}
+			for (const API_Guid& hotspotGuid : hotspotsToDelete) {
+				HotspotManager::RemoveHotspot (hotspotGuid);
+			}
+			deletedHotspots = (Int32)hotspotsToDelete.GetSize ();
+		}
+		DimensionSets::Replace (setId, desired);
+		return NoError;
+	});
+
+	if (err != NoError) {
+		return MakeErrorResponse ((Int32)err, "Failed to sync dimension set in Archicad");
+	}
+
+	Int32 failedCount = 0;
+	GS::Array<GS::ObjectState> results;
+	results.SetCapacity (items.GetSize ());
+	for (const LinearDimensionItem& item : items) {
+		GS::ObjectState resultOS;
+		if (item.errorCode != 0) {
+			resultOS.Add ("error", item.errorCode);
+			++failedCount;
+		} else {
+			resultOS.Add ("hotspotGuid1", APIGuidToString (item.hotspotGuid1));
+			resultOS.Add ("hotspotGuid2", APIGuidToString (item.hotspotGuid2));
+			resultOS.Add ("dimensionGuid", APIGuidToString (item.dimensionGuid));
+		}
+		results.Push (resultOS);
+	}
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("createdHotspots", createdHotspots);
+	response.Add ("movedHotspots", movedHotspots);
+	response.Add ("deletedHotspots", deletedHotspots);
+	response.Add ("createdDimensions", createdDimensions);
+	response.Add ("deletedDimensions", deletedDimensions);
+	response.Add ("unchangedDimensions", unchangedDimensions);
+	response.Add ("failedCount", failedCount);
+	response.Add ("cancelled", cancelled);
+	response.Add ("results", results);
+	return response;
+}
+
+void SyncDimensionSetCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// GetChangesSinceCommand implementation
+// =============================================================================
+
+namespace {
+	// { "success", "revision", "resyncRequired", "added": [...], "modified": [...], "deleted": [guid, ...] }
+	// Added / modified entries: { "guid", "type": "hotspot", "x", "y" } or { "guid", "type": "dimension", "nodes": [x0, y0, ...] }
+	GS::ObjectState BuildChangesResponse (UInt64 sinceRevision)
+	{
+		GS::Array<ChangeFeed::Change> changes;
+		UInt64 currentRevision = 0;
+		const bool available = ChangeFeed::GetChangesSince (sinceRevision, changes, currentRevision);
+
+		GS::Array<GS::ObjectState> added;
+		GS::Array<GS::ObjectState> modified;
+		GS::Array<GS::UniString> deleted;
+		for (const ChangeFeed::Change& change : changes) {
+			const GS::UniString guidStr = APIGuidToString (change.guid);
+			if (change.kind == ChangeFeed::ChangeKind::Deleted) {
+				deleted.Push (guidStr);
+				continue;
+			}
+
+			GS::ObjectState entryOS;
+			bool readable = false;
+			if (change.type == API_HotspotID) {
+				API_Coord pos = {};
+				if (SpatialIndex::GetHotspotPosition (change.guid, pos)) {
+					entryOS.Add ("guid", guidStr);
+					entryOS.Add ("type", "hotspot");
+					entryOS.Add ("x", pos.x);
+					entryOS.Add ("y", pos.y);
+					readable = true;
+				}
+			} else if (change.type == API_DimensionID) {
+				readable = DimensionToObjectState (change.guid, true, entryOS);
+				if (readable) {
+					entryOS.Add ("type", "dimension");
+				}
+			}
+
+			if (!readable) {
+				// Gone again by the time the client asks
+				deleted.Push (guidStr);
+			} else if (change.kind == ChangeFeed::ChangeKind::Added) {
+				added.Push (entryOS);
+			} else {
+				modified.Push (entryOS);
+			}
+		}
+
+		GS::ObjectState response;
+		response.Add ("success", true);
+		response.Add ("revision", currentRevision);
+		response.Add ("resyncRequired", !available);
+		response.Add ("added", added);
+		response.Add ("modified", modified);
+		response.Add ("deleted", deleted);
+		return response;
+	}
+
+	UInt64 GetSinceRevision (const GS::ObjectState& parameters)
+	{
+		double sinceRevision = 0.0;
+		if (parameters.Contains ("sinceRevision") && parameters.Get ("sinceRevision", sinceRevision) && sinceRevision > 0.0) {
+			return (UInt64)sinceRevision;
+		}
+		return 0;
+	}
+}
+
+GS::String GetChangesSinceCommand::GetName () const
+{
+	return "GetChangesSince";
+}
+
+GS::String GetChangesSinceCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> GetChangesSinceCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> GetChangesSinceCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> GetChangesSinceCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "sinceRevision" } - revision returned by the previous call (0 on first call)
+// Output: see BuildChangesResponse; on "resyncRequired" the client re-reads everything
+//         (e.g. GetDimensions with trackedOnly) and continues from "revision"
+GS::ObjectState GetChangesSinceCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	return BuildChangesResponse (GetSinceRevision (parameters));
+}
+
+void GetChangesSinceCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// WaitForChangesCommand implementation
+// =============================================================================
+
+namespace {
+	constexpr UInt32 DefaultWaitTimeoutMs = 8000;		// below the client's 10 s request timeout
+	constexpr UInt32 MaxWaitTimeoutMs = 9000;			// longer waits would outlive the client request and lose the reply
+
+	// Same shape as BuildChangesResponse, but only from what the feed recorded -
+	// safe off the main thread (dimensions carry no geometry: it follows their hotspots)
+	GS::ObjectState BuildRecordedChangesResponse (UInt64 sinceRevision, bool timedOut)
+	{
+		GS::Array<ChangeFeed::Change> changes;
+		UInt64 currentRevision = 0;
+		const bool available = ChangeFeed::GetChangesSince (sinceRevision, changes, currentRevision);
+
+		GS::Array<GS::ObjectState> added;
+		GS::Array<GS::ObjectState> modified;
+		GS::Array<GS::UniString> deleted;
+		for (const ChangeFeed::Change& change : changes) {
+			const GS::UniString guidStr = APIGuidToString (change.guid);
+			if (change.kind == ChangeFeed::ChangeKind::Deleted) {
+				deleted.Push (guidStr);
+				continue;
+			}
+
+			GS::ObjectState entryOS;
+			entryOS.Add ("guid", guidStr);
+			entryOS.Add ("type", change.type == API_HotspotID ? "hotspot" : "dimension");
+			if (change.hasPosition) {
+				entryOS.Add ("x", change.position.x);
+				entryOS.Add ("y", change.position.y);
+			}
+			if (change.kind == ChangeFeed::ChangeKind::Added) {
+				added.Push (entryOS);
+			} else {
+				modified.Push (entryOS);
+			}
+		}
+
+		GS::ObjectState response;
+		response.Add ("success", true);
+		response.Add ("revision", currentRevision);
+		response.Add ("resyncRequired", !available);
+		response.Add ("timedOut", timedOut);
+		response.Add ("added", added);
+		response.Add ("modified", modified);
+		response.Add ("deleted", deleted);
+		return response;
+	}
+}
+
+GS::String WaitForChangesCommand::GetName () const
+{
+	return "WaitForChanges";
+}
+
+GS::String WaitForChangesCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> WaitForChangesCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> WaitForChangesCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> WaitForChangesCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "sinceRevision", "timeoutMs" }
+// Output: { "success", "revision", "resyncRequired", "timedOut", "added", "modified", "deleted" }
+// Runs on the connection thread: must not call ACAPI, only ChangeFeed
+GS::ObjectState WaitForChangesCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	const UInt64 sinceRevision = GetSinceRevision (parameters);
+
+	UInt32 timeoutMs = DefaultWaitTimeoutMs;
+	if (parameters.Contains ("timeoutMs")) {
+		Int32 timeoutValue = 0;
+		if (parameters.Get ("timeoutMs", timeoutValue) && timeoutValue >= 0) {
+			timeoutMs = std::min ((UInt32)timeoutValue, MaxWaitTimeoutMs);
+		}
+	}
+
+	const bool changed = ChangeFeed::WaitForChanges (sinceRevision, timeoutMs);
+	return BuildRecordedChangesResponse (sinceRevision, !changed);
+}
+
+void WaitForChangesCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// BeginSessionCommand implementation
+// =============================================================================
+
+GS::String BeginSessionCommand::GetName () const
+{
+	return "BeginSession";
+}
+
+GS::String BeginSessionCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> BeginSessionCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> BeginSessionCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> BeginSessionCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  {}
+// Output: { "success" } - until CommitSession, every command that modifies the project
+//         (see UndoSession.hpp) answers { "success", "queued", "queueIndex" };
+//         a session idle for UndoSession::SessionTimeoutMs is discarded
+GS::ObjectState BeginSessionCommand::Execute (const GS::ObjectState& /*parameters*/, GS::ProcessControl& /*processControl*/) const
+{
+	UndoSession::Begin ();
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	return response;
+}
+
+void BeginSessionCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// CommitSessionCommand implementation
+// =============================================================================
+
+GS::String CommitSessionCommand::GetName () const
+{
+	return "CommitSession";
+}
+
+GS::String CommitSessionCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> CommitSessionCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CommitSessionCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CommitSessionCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "discard" } (optional - drop the queue instead of executing it)
+// Output: { "success", "executedCount", "queuedCount", "results": [ response of each queued command, in queue order ] }
+GS::ObjectState CommitSessionCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const
+{
+	if (parameters.Contains ("discard")) {
+		bool discard = false;
+		if (parameters.Get ("discard", discard) && discard) {
+			UndoSession::Discard ();
+			GS::ObjectState response;
+			response.Add ("success", true);
+			response.Add ("executedCount", (Int32)0);
+			return response;
+		}
+	}
+
+	return UndoSession::Commit (processControl);
+}
+
+void CommitSessionCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// UpsertHotspotsCommand implementation (batch)
+// =============================================================================
+
+namespace {
+	constexpr double DefaultMoveEpsilon = 1e-6;
+
+	struct HotspotItem {
+		API_Coord		coord = {};
+		GS::UniString	rhinoPointGuid;
+		API_Guid		hotspotGuid = APINULLGuid;
+		Int32			errorCode = 0;		// 0 - ok, < 0 - failed
+		bool			needsWork = true;	// create or real move
+		HotspotUpsert	outcome = HotspotUpsert::Unchanged;
+	};
+}
+
+GS::String UpsertHotspotsCommand::GetName () const
+{
+	return "UpsertHotspots";
+}
+
+GS::String UpsertHotspotsCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> UpsertHotspotsCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> UpsertHotspotsCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> UpsertHotspotsCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "points": [ { "rhinoPointGuid", "x", "y" }, ... ], "moveEpsilon", "setId" }
+// Output: { "success", "createdCount", "movedCount", "unchangedCount", "failedCount",
+//           "hotspotGuids": [ guid per input point, "" if failed ] }
+GS::ObjectState UpsertHotspotsCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const
+{
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
+	GS::Array<GS::ObjectState> pointsOS;
+	if (!parameters.Contains ("points") || !parameters.Get ("points", pointsOS)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'points' array");
+	}
+
+	double moveEpsilon = DefaultMoveEpsilon;
+	if (parameters.Contains ("moveEpsilon")) {
+		double epsilonValue = 0.0;
+		if (parameters.Get ("moveEpsilon", epsilonValue) && epsilonValue >= 0.0) {
+			moveEpsilon = epsilonValue;
+		}
+	}
+
+	GS::UniString setId;
+	const bool hasSet = GetSetIdFromObjectState (parameters, setId);
+	const DimensionSets::Members* set = hasSet ? DimensionSets::Get (setId) : nullptr;
+
+	// Resolve through the index first: points that did not move need no undo step at all
+	GS::Array<HotspotItem> items;
+	items.SetCapacity (pointsOS.GetSize ());
+	bool anyWork = false;
+	for (const GS::ObjectState& pointOS : pointsOS) {
+		HotspotItem item;
+		if (!pointOS.Get ("x", item.coord.x) || !pointOS.Get ("y", item.coord.y)) {
+			item.errorCode = -1;
+		} else if (!pointOS.Get ("rhinoPointGuid", item.rhinoPointGuid) || item.rhinoPointGuid.IsEmpty ()) {
+			item.errorCode = -4;
+		} else {
+			item.hotspotGuid = HotspotManager::FindHotspotByRhinoGuid (item.rhinoPointGuid);
+			item.needsWork = item.hotspotGuid == APINULLGuid || !IsHotspotAt (item.hotspotGuid, item.coord, moveEpsilon);
+			// Joining the set is a change of the stored maps, which needs an undo step too
+			const bool joinsSet = hasSet && (set == nullptr || !set->hotspots.Contains (item.hotspotGuid));
+			anyWork = anyWork || item.needsWork || joinsSet;
+		}
+		items.Push (item);
+	}
+
+	GSErrCode err = NoError;
+	if (anyWork) {
+		err = UndoSession::RunUndoable ("UpsertHotspots", [&]() -> GSErrCode {
+			for (HotspotItem& item : items) {
+				if (item.errorCode != 0 || !item.needsWork) {
+					continue;
+				}
+				if (processControl.IsBreaked ()) {
+					item.errorCode = -6;		// cancelled in Archicad
+					continue;
+				}
+				if (UpsertHotspotInUndoScope (item.coord, item.rhinoPointGuid, item.hotspotGuid, &item.outcome, moveEpsilon) != NoError) {
+					item.errorCode = -5;
+				}
+			}
+			if (hasSet) {
+				for (const HotspotItem& item : items) {
+					if (item.errorCode == 0) {
+						DimensionSets::AddHotspot (setId, item.hotspotGuid);
+					}
+				}
+			}
+			// Per-item failures are reported in hotspotGuids; keep what succeeded
+			return NoError;
+		});
+	}
+
+	if (err != NoError) {
+		return MakeErrorResponse ((Int32)err, "Failed to upsert hotspots in Archicad");
+	}
+
+	Int32 createdCount = 0;
+	Int32 movedCount = 0;
+	Int32 unchangedCount = 0;
+	Int32 failedCount = 0;
+	GS::Array<GS::UniString> hotspotGuids;
+	hotspotGuids.SetCapacity (items.GetSize ());
+	for (const HotspotItem& item : items) {
+		if (item.errorCode != 0) {
+			hotspotGuids.Push (GS::EmptyUniString);
+			++failedCount;
+			continue;
+		}
+		hotspotGuids.Push (APIGuidToString (item.hotspotGuid));
+		if (item.outcome == HotspotUpsert::Created) {
+			++createdCount;
+		} else if (item.outcome == HotspotUpsert::Moved) {
+			++movedCount;
+		} else {
+			++unchangedCount;
+		}
+	}
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("createdCount", createdCount);
+	response.Add ("movedCount", movedCount);
+	response.Add ("unchangedCount", unchangedCount);
+	response.Add ("failedCount", failedCount);
+	response.Add ("hotspotGuids", hotspotGuids);
+	return response;
+}
+
+void UpsertHotspotsCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// SetLiveDragCommand implementation
+// =============================================================================
+
+GS::String SetLiveDragCommand::GetName () const
+{
+	return "SetLiveDrag";
+}
+
+GS::String SetLiveDragCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> SetLiveDragCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> SetLiveDragCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> SetLiveDragCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "enabled", "frameRate" } (frameRate: flushes per second, default 30)
+// Output: { "success", "enabled", "flushedCount" } - switching off ends the drag in one undo step
+GS::ObjectState SetLiveDragCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	bool enabled = false;
+	if (!parameters.Contains ("enabled") || !parameters.Get ("enabled", enabled)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'enabled'");
+	}
+
+	double frameRate = LiveDrag::DefaultFrameRate;
+	if (parameters.Contains ("frameRate")) {
+		double rateValue = 0.0;
+		if (parameters.Get ("frameRate", rateValue) && rateValue > 0.0) {
+			frameRate = rateValue;
+		}
+	}
+
+	const UInt32 pendingCount = LiveDrag::GetPendingCount ();
+	LiveDrag::SetEnabled (enabled, frameRate);
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("enabled", LiveDrag::IsEnabled ());
+	response.Add ("flushedCount", (Int32)(pendingCount - LiveDrag::GetPendingCount ()));
+	return response;
+}
+
+void SetLiveDragCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// FlushLiveDragCommand implementation
+// =============================================================================
+
+GS::String FlushLiveDragCommand::GetName () const
+{
+	return "FlushLiveDrag";
+}
+
+GS::String FlushLiveDragCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> FlushLiveDragCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> FlushLiveDragCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> FlushLiveDragCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  {}
+// Output: { "success", "movedCount" } - ends the current drag: its final positions become one undo step
+GS::ObjectState FlushLiveDragCommand::Execute (const GS::ObjectState& /*parameters*/, GS::ProcessControl& /*processControl*/) const
+{
+	const UInt32 movedCount = LiveDrag::Flush ();
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("movedCount", (Int32)movedCount);
+	return response;
+}
+
+void FlushLiveDragCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// TransformHotspotsCommand implementation
+// =============================================================================
+
+namespace {
+	// x' = a * x + b * y + tx,  y' = c * x + d * y + ty
+	struct AffineTransform2D {
+		double a = 1.0, b = 0.0, c = 0.0, d = 1.0;
+		double tx = 0.0, ty = 0.0;
+
+		API_Coord Apply (const API_Coord& p) const
+		{
+			API_Coord result;
+			result.x = a * p.x + b * p.y + tx;
+			result.y = c * p.x + d * p.y + ty;
+			return result;
+		}
+	};
+
+	bool GetTransformFromObjectState (const GS::ObjectState& os, AffineTransform2D& transform)
+	{
+		GS::ObjectState matrixOS;
+		if (!os.Contains ("matrix") || !os.Get ("matrix", matrixOS)) {
+			return false;
+		}
+		return matrixOS.Get ("a", transform.a) && matrixOS.Get ("b", transform.b) &&
+			   matrixOS.Get ("c", transform.c) && matrixOS.Get ("d", transform.d) &&
+			   matrixOS.Get ("tx", transform.tx) && matrixOS.Get ("ty", transform.ty);
+	}
+}
+
+GS::String TransformHotspotsCommand::GetName () const
+{
+	return "TransformHotspots";
+}
+
+GS::String TransformHotspotsCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> TransformHotspotsCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> TransformHotspotsCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> TransformHotspotsCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "setId" | "hotspotGuids": [ ... ], "matrix": { a, b, c, d, tx, ty } }
+//         x' = a * x + b * y + tx,  y' = c * x + d * y + ty
+// Output: { "success", "movedCount", "failedCount" }
+GS::ObjectState TransformHotspotsCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
+	AffineTransform2D transform;
+	if (!GetTransformFromObjectState (parameters, transform)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'matrix' (a, b, c, d, tx, ty)");
+	}
+
+	// Members of the set: hotspots of a named set, or an explicit list
+	GS::Array<API_Guid> hotspotGuids;
+	GS::UniString setId;
+	GS::Array<GS::UniString> guidStrings;
+	if (GetSetIdFromObjectState (parameters, setId)) {
+		const DimensionSets::Members* set = DimensionSets::Get (setId);
+		if (set == nullptr) {
+			return MakeErrorResponse (-2, "Unknown setId");
+		}
+		hotspotGuids.SetCapacity (set->hotspots.GetSize ());
+		for (const API_Guid& hotspotGuid : set->hotspots) {
+			hotspotGuids.Push (hotspotGuid);
+		}
+	} else if (parameters.Contains ("hotspotGuids") && parameters.Get ("hotspotGuids", guidStrings)) {
+		hotspotGuids.SetCapacity (guidStrings.GetSize ());
+		for (const GS::UniString& guidStr : guidStrings) {
+			hotspotGuids.Push (APIGuidFromString (guidStr.ToCStr ().Get ()));
+		}
+	} else {
+		return MakeErrorResponse (-1, "Missing set selector ('setId' or 'hotspotGuids')");
+	}
+
+	Int32 movedCount = 0;
+	Int32 failedCount = 0;
+	GSErrCode err = UndoSession::RunUndoable ("TransformHotspots", [&]() -> GSErrCode {
+		API_Element mask = {};
+		ACAPI_ELEMENT_MASK_CLEAR (mask);
+		ACAPI_ELEMENT_MASK_SET (mask, API_HotspotType, pos);
+
+		for (const API_Guid& hotspotGuid : hotspotGuids) {
+			API_Element hotspot = {};
+			hotspot.header.guid = hotspotGuid;
+			if (hotspotGuid == APINULLGuid || ACAPI_Element_Get (&hotspot) != NoError || hotspot.header.type != API_HotspotID) {
+				++failedCount;
+				continue;
+			}
+			const API_Coord newPos = transform.Apply (hotspot.hotspot.pos);
+			hotspot.hotspot.pos = newPos;
+			if (ACAPI_Element_Change (&hotspot, &mask, nullptr, 0, true) != NoError) {
+				++failedCount;
+				continue;
+			}
+			SpatialIndex::SetHotspot (hotspotGuid, newPos);
+			ChangeFeed::Record (ChangeFeed::ChangeKind::Modified, hotspotGuid, API_HotspotID, &newPos);
+			++movedCount;
+		}
+		// Per-item failures are counted; keep what succeeded
+		return NoError;
+	});
+
+	if (err != NoError) {
+		return MakeErrorResponse ((Int32)err, "Failed to transform hotspots in Archicad");
+	}
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("movedCount", movedCount);
+	response.Add ("failedCount", failedCount);
+	return response;
+}
+
+void TransformHotspotsCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// GetDimensionSetCommand implementation
+// =============================================================================
+
+GS::String GetDimensionSetCommand::GetName () const
+{
+	return "GetDimensionSet";
+}
+
+GS::String GetDimensionSetCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> GetDimensionSetCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> GetDimensionSetCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> GetDimensionSetCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "setId" } or {}
+// Output: { "success", "setId", "hotspotGuids": [ ... ], "dimensionGuids": [ ... ] } - live members of the set
+//         { "success", "sets": [ { "setId", "hotspotCount", "dimensionCount" }, ... ] } - without "setId"
+GS::ObjectState GetDimensionSetCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	GS::ObjectState response;
+	GS::UniString setId;
+	if (!GetSetIdFromObjectState (parameters, setId)) {
+		GS::Array<GS::ObjectState> sets;
+		for (const GS::UniString& id : DimensionSets::GetSetIds ()) {
+			const DimensionSets::Members* members = DimensionSets::Get (id);
+			GS::ObjectState setOS;
+			setOS.Add ("setId", id);
+			setOS.Add ("hotspotCount", (Int32)members->hotspots.GetSize ());
+			setOS.Add ("dimensionCount", (Int32)members->dimensions.GetSize ());
+			sets.Push (setOS);
+		}
+		response.Add ("success", true);
+		response.Add ("sets", sets);
+		return response;
+	}
+
+	GS::Array<GS::UniString> hotspotGuids;
+	GS::Array<GS::UniString> dimensionGuids;
+	const DimensionSets::Members* members = DimensionSets::Get (setId);
+	if (members != nullptr) {
+		hotspotGuids.SetCapacity (members->hotspots.GetSize ());
+		for (const API_Guid& hotspotGuid : members->hotspots) {
+			if (ElementTracker::IsAlive (hotspotGuid, API_HotspotID)) {
+				hotspotGuids.Push (APIGuidToString (hotspotGuid));
+			}
+		}
+		dimensionGuids.SetCapacity (members->dimensions.GetSize ());
+		for (const API_Guid& dimensionGuid : members->dimensions) {
+			if (ElementTracker::IsAlive (dimensionGuid, API_DimensionID)) {
+				dimensionGuids.Push (APIGuidToString (dimensionGuid));
+			}
+		}
+	}
+
+	response.Add ("success", true);
+	response.Add ("setId", setId);
+	response.Add ("hotspotGuids", hotspotGuids);
+	response.Add ("dimensionGuids", dimensionGuids);
+	return response;
+}
+
+void GetDimensionSetCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// DeleteDimensionSetCommand implementation
+// =============================================================================
+
+GS::String DeleteDimensionSetCommand::GetName () const
+{
+	return "DeleteDimensionSet";
+}
+
+GS::String DeleteDimensionSetCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> DeleteDimensionSetCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> DeleteDimensionSetCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> DeleteDimensionSetCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "setId" }
+// Output: { "success", "deletedHotspots", "deletedDimensions" }
+GS::ObjectState DeleteDimensionSetCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
+	GS::UniString setId;
+	if (!GetSetIdFromObjectState (parameters, setId)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'setId'");
+	}
+
+	const DimensionSets::Members* members = DimensionSets::Get (setId);
+	if (members == nullptr) {
+		GS::ObjectState response;
+		response.Add ("success", true);
+		response.Add ("deletedHotspots", (Int32)0);
+		response.Add ("deletedDimensions", (Int32)0);
+		return response;
+	}
+
+	// Only what no other set owns; the rest just leaves this set
+	GS::Array<API_Guid> dimensionsToDelete;
+	for (const API_Guid& dimensionGuid : members->dimensions) {
+		if (!DimensionSets::IsDimensionInOtherSet (setId, dimensionGuid) && ElementTracker::IsAlive (dimensionGuid, API_DimensionID)) {
+			dimensionsToDelete.Push (dimensionGuid);
+		}
+	}
+	GS::Array<API_Guid> hotspotsToDelete;
+	for (const API_Guid& hotspotGuid : members->hotspots) {
+		if (!DimensionSets::IsHotspotInOtherSet (setId, hotspotGuid) && ElementTracker::IsAlive (hotspotGuid, API_HotspotID)) {
+			hotspotsToDelete.Push (hotspotGuid);
+		}
+	}
+
+	GSErrCode err = UndoSession::RunUndoable ("DeleteDimensionSet", [&]() -> GSErrCode {
+		if (!dimensionsToDelete.IsEmpty ()) {
+			GSErrCode deleteErr = ACAPI_Element_Delete (dimensionsToDelete);
+			if (deleteErr != NoError) {
+				return deleteErr;
+			}
+		}
+		if (!hotspotsToDelete.IsEmpty ()) {
+			GSErrCode deleteErr = ACAPI_Element_Delete (hotspotsToDelete);
+			if (deleteErr != NoError) {
+				return deleteErr;
+			}
+		}
+
+		for (const API_Guid& dimensionGuid : dimensionsToDelete) {
+			DimensionManager::RemoveDimension (dimensionGuid);
+		}
+		for (const API_Guid& hotspotGuid : hotspotsToDelete) {
+			HotspotManager::RemoveHotspot (hotspotGuid);
+		}
+		DimensionSets::Remove (setId);
+		return NoError;
+	});
+
+	if (err != NoError) {
+		return MakeErrorResponse ((Int32)err, "Failed to delete dimension set in Archicad");
+	}
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("deletedHotspots", (Int32)hotspotsToDelete.GetSize ());
+	response.Add ("deletedDimensions", (Int32)dimensionsToDelete.GetSize ());
+	return response;
+}
+
+void DeleteDimensionSetCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// SweepHotspotsCommand implementation
+// =============================================================================
+
+GS::String SweepHotspotsCommand::GetName () const
+{
+	return "SweepHotspots";
+}
+
+GS::String SweepHotspotsCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> SweepHotspotsCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> SweepHotspotsCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> SweepHotspotsCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "maxCount" } - hotspots examined at most, default HotspotSweeper::DefaultChunkSize
+// Output: { "success", "deletedCount", "pendingCount" } - meant to be sent from the client's idle timer
+GS::ObjectState SweepHotspotsCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	// Inside a session the work is queued and done by CommitSession
+	if (UndoSession::IsRecording ()) {
+		return UndoSession::Enqueue (*this, parameters);
+	}
+
+	UInt32 maxCount = HotspotSweeper::DefaultChunkSize;
+	if (parameters.Contains ("maxCount")) {
+		Int32 maxCountValue = 0;
+		if (parameters.Get ("maxCount", maxCountValue) && maxCountValue > 0) {
+			maxCount = (UInt32)maxCountValue;
+		}
+	}
+
+	const UInt32 deletedCount = HotspotSweeper::Sweep (maxCount);
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("deletedCount", (Int32)deletedCount);
+	response.Add ("pendingCount", (Int32)HotspotSweeper::GetPendingCount ());
+	return response;
+}
+
+void SweepHotspotsCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// SubmitJobCommand implementation
+// =============================================================================
+
+GS::String SubmitJobCommand::GetName () const
+{
+	return "SubmitJob";
+}
+
+GS::String SubmitJobCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> SubmitJobCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> SubmitJobCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> SubmitJobCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "command": "CreateLinearDimensions" | "UpsertHotspots", "items": [ pairs / points ],
+//           "parameters": { other parameters of the command, e.g. "setId" }, "chunkSize" }
+// Output: { "success", "jobId", "totalCount" } - the job runs from the event loop, poll GetJobStatus to follow it
+GS::ObjectState SubmitJobCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	GS::UniString commandName;
+	const char* itemsKey = nullptr;
+	if (!parameters.Contains ("command") || !parameters.Get ("command", commandName) || !JobQueue::GetItemsKey (commandName, itemsKey)) {
+		return MakeErrorResponse (-1, "Missing or unsupported 'command' (CreateLinearDimensions, UpsertHotspots)");
+	}
+
+	GS::Array<GS::ObjectState> items;
+	if (!parameters.Contains ("items") || !parameters.Get ("items", items)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'items' array");
+	}
+
+	GS::ObjectState commandParameters;
+	if (parameters.Contains ("parameters") && !parameters.Get ("parameters", commandParameters)) {
+		return MakeErrorResponse (-1, "Invalid 'parameters' object");
+	}
+	if (commandParameters.Contains (itemsKey)) {
+		return MakeErrorResponse (-1, "Items go to 'items', not to 'parameters'");
+	}
+
+	UInt32 chunkSize = JobQueue::DefaultChunkSize;
+	if (parameters.Contains ("chunkSize")) {
+		Int32 chunkSizeValue = 0;
+		if (parameters.Get ("chunkSize", chunkSizeValue) && chunkSizeValue > 0) {
+			chunkSize = (UInt32)chunkSizeValue;
+		}
+	}
+
+	const Int32 jobId = JobQueue::Submit (commandName, items, commandParameters, chunkSize);
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("jobId", jobId);
+	response.Add ("totalCount", (Int32)items.GetSize ());
+	return response;
+}
+
+void SubmitJobCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// GetJobStatusCommand implementation
+// =============================================================================
+
+GS::String GetJobStatusCommand::GetName () const
+{
+	return "GetJobStatus";
+}
+
+GS::String GetJobStatusCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> GetJobStatusCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> GetJobStatusCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> GetJobStatusCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+namespace {
+	constexpr UInt32 MaxJobStatusBudgetMs = 9000;		// longer runs would outlive the client request and lose the reply
+}
+
+// Input:  { "jobId", "fromChunk", "budgetMs" }
+//         jobs advance from the event loop; with budgetMs > 0 chunks of the oldest active job also run now
+//         (at most MaxJobStatusBudgetMs); a break (Escape) cancels the job "jobId"
+// Output: { "success", "jobId", "command", "state", "doneCount", "totalCount", "chunkCount",
+//           "chunkResults": [ responses of the chunks from "fromChunk" on ], "error" }
+GS::ObjectState GetJobStatusCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const
+{
+	Int32 jobId = 0;
+	if (!parameters.Contains ("jobId") || !parameters.Get ("jobId", jobId)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'jobId'");
+	}
+
+	UInt32 fromChunk = 0;
+	if (parameters.Contains ("fromChunk")) {
+		Int32 fromChunkValue = 0;
+		if (parameters.Get ("fromChunk", fromChunkValue) && fromChunkValue > 0) {
+			fromChunk = (UInt32)fromChunkValue;
+		}
+	}
+
+	UInt32 budgetMs = 0;
+	if (parameters.Contains ("budgetMs")) {
+		Int32 budgetValue = 0;
+		if (parameters.Get ("budgetMs", budgetValue) && budgetValue >= 0) {
+			budgetMs = std::min ((UInt32)budgetValue, MaxJobStatusBudgetMs);
+		}
+	}
+
+	const bool broken = (budgetMs > 0) ? !JobQueue::RunTick (budgetMs, processControl) : processControl.IsBreaked ();
+	if (broken) {
+		JobQueue::Cancel (jobId, "Cancelled in Archicad");
+	}
+
+	GS::ObjectState response;
+	if (!JobQueue::GetStatus (jobId, fromChunk, response)) {
+		return MakeErrorResponse (-2, "Unknown jobId");
+	}
+	response.Add ("success", true);
+	return response;
+}
+
+void GetJobStatusCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
+
+// =============================================================================
+// CancelJobCommand implementation
+// =============================================================================
+
+GS::String CancelJobCommand::GetName () const
+{
+	return "CancelJob";
+}
+
+GS::String CancelJobCommand::GetNamespace () const
+{
+	return "DimensionGh";
+}
+
+GS::Optional<GS::UniString> CancelJobCommand::GetSchemaDefinitions () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CancelJobCommand::GetInputParametersSchema () const
+{
+	return GS::NoValue;
+}
+
+GS::Optional<GS::UniString> CancelJobCommand::GetResponseSchema () const
+{
+	return GS::NoValue;
+}
+
+// Input:  { "jobId" }
+// Output: { "success", "cancelled" } - chunks that already ran stay (each was its own undo step)
+GS::ObjectState CancelJobCommand::Execute (const GS::ObjectState& parameters, GS::ProcessControl& /*processControl*/) const
+{
+	Int32 jobId = 0;
+	if (!parameters.Contains ("jobId") || !parameters.Get ("jobId", jobId)) {
+		return MakeErrorResponse (-1, "Missing or invalid 'jobId'");
+	}
+
+	GS::ObjectState response;
+	response.Add ("success", true);
+	response.Add ("cancelled", JobQueue::Cancel (jobId, "Cancelled by client"));
+	return response;
+}
+
+void CancelJobCommand::OnResponseValidationFailed (const GS::ObjectState& /*response*/) const
+{
+}
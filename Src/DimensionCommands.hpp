@@ -47,7 +47,7 @@ public:
 };
 
 // -----------------------------------------------------------------------------
-// GetDimensions Command - get all dimensions from project
+// GetDimensions Command - get dimensions from project (filtered, paged)
 // -----------------------------------------------------------------------------
 
 class GetDimensionsCommand : public API_AddOnCommand {
@@ -84,6 +84,104 @@ public:
 	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
 };
 
+// -----------------------------------------------------------------------------
+// CreateLinearDimensions Command - upsert hotspots and dimensions for N point
+// pairs in a single undo step
+// -----------------------------------------------------------------------------
+
+class CreateLinearDimensionsCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// CreateDimensionChain Command - one dimension with a node per point
+// -----------------------------------------------------------------------------
+
+class CreateDimensionChainCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// SyncDimensionSet Command - bring the hotspots and dimensions of one named set
+// to the desired content with the minimal creates, moves and deletes
+// -----------------------------------------------------------------------------
+
+class SyncDimensionSetCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// GetChangesSince Command - delta of tracked hotspots/dimensions since a revision
+// -----------------------------------------------------------------------------
+
+class GetChangesSinceCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// WaitForChanges Command - long poll: block until tracked elements change
+// Executes on the calling thread so the main thread stays free while waiting
+// -----------------------------------------------------------------------------
+
+class WaitForChangesCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ExecuteOnCurrentThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
 // -----------------------------------------------------------------------------
 // CreateHotspot Command - create hotspot on element by coordinates
 // -----------------------------------------------------------------------------
@@ -103,6 +201,26 @@ public:
 	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
 };
 
+// -----------------------------------------------------------------------------
+// UpsertHotspots Command - create / move N hotspots by rhinoPointGuid in one
+// undo step, skipping moves below an epsilon
+// -----------------------------------------------------------------------------
+
+class UpsertHotspotsCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
 // -----------------------------------------------------------------------------
 // UpdateHotspot Command - update hotspot position by GUID
 // -----------------------------------------------------------------------------
@@ -122,6 +240,65 @@ public:
 	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
 };
 
+// -----------------------------------------------------------------------------
+// GetDimensionSet Command - members of one named set, or the list of sets
+// -----------------------------------------------------------------------------
+
+class GetDimensionSetCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// DeleteDimensionSet Command - delete everything one named set owns
+// (elements shared with other sets stay) in one undo step
+// -----------------------------------------------------------------------------
+
+class DeleteDimensionSetCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// TransformHotspots Command - apply one 2D affine transform to a whole hotspot
+// set (named set or GUID list) in one undo step
+// -----------------------------------------------------------------------------
+
+class TransformHotspotsCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
 // -----------------------------------------------------------------------------
 // DeleteHotspot Command - delete hotspot by GUID
 // -----------------------------------------------------------------------------
@@ -141,6 +318,26 @@ public:
 	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
 };
 
+// -----------------------------------------------------------------------------
+// SweepHotspots Command - delete one bounded chunk of unreferenced hotspots
+// (see HotspotSweeper)
+// -----------------------------------------------------------------------------
+
+class SweepHotspotsCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
 // -----------------------------------------------------------------------------
 // DeleteAllHotspots Command - delete all hotspots created by this add-on
 // -----------------------------------------------------------------------------
@@ -160,6 +357,140 @@ public:
 	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
 };
 
+// -----------------------------------------------------------------------------
+// BeginSession Command - start queueing modifying commands
+// -----------------------------------------------------------------------------
+
+class BeginSessionCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// CommitSession Command - execute the queued commands in one undo step
+// -----------------------------------------------------------------------------
+
+class CommitSessionCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// SetLiveDrag Command - switch coalescing of UpdateHotspot requests on / off
+// -----------------------------------------------------------------------------
+
+class SetLiveDragCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// FlushLiveDrag Command - end the current drag in one undo step now
+// -----------------------------------------------------------------------------
+
+class FlushLiveDragCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// SubmitJob Command - queue a large batch as a chunked job, answer
+// with its ID at once (see JobQueue)
+// -----------------------------------------------------------------------------
+
+class SubmitJobCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// GetJobStatus Command - report progress and partial results of one job
+// -----------------------------------------------------------------------------
+
+class GetJobStatusCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
+// -----------------------------------------------------------------------------
+// CancelJob Command - stop a queued or running job
+// -----------------------------------------------------------------------------
+
+class CancelJobCommand : public API_AddOnCommand {
+public:
+	virtual GS::String							GetName () const override;
+	virtual GS::String							GetNamespace () const override;
+	virtual GS::Optional<GS::UniString>			GetSchemaDefinitions () const override;
+	virtual GS::Optional<GS::UniString>			GetInputParametersSchema () const override;
+	virtual GS::Optional<GS::UniString>			GetResponseSchema () const override;
+	
+	virtual API_AddOnCommandExecutionPolicy		GetExecutionPolicy () const override { return API_AddOnCommandExecutionPolicy::ScheduleForExecutionOnMainThread; }
+	virtual bool								IsProcessWindowVisible () const override { return false; }
+
+	virtual GS::ObjectState						Execute (const GS::ObjectState& parameters, GS::ProcessControl& processControl) const override;
+	virtual void								OnResponseValidationFailed (const GS::ObjectState& response) const override;
+};
+
 // -----------------------------------------------------------------------------
 // Global storage for created hotspots (for cleanup on disconnect)
 // -----------------------------------------------------------------------------
@@ -168,12 +499,24 @@ namespace HotspotManager {
 	// Add hotspot GUID to the list (with optional rhinoPointGuid for mapping)
 	void AddHotspot(const API_Guid& hotspotGuid, const GS::UniString& rhinoPointGuid = GS::EmptyUniString);
 	
+	// Track a hotspot from the stored project state (see TrackingStore)
+	void RestoreHotspot(const API_Guid& hotspotGuid, const API_Guid& rhinoKey);
+	
 	// Remove hotspot GUID from the list
 	void RemoveHotspot(const API_Guid& hotspotGuid);
 	
+	// Check if hotspot was created by this add-on
+	bool IsTrackedHotspot(const API_Guid& hotspotGuid);
+	
 	// Find hotspot by rhinoPointGuid
 	API_Guid FindHotspotByRhinoGuid(const GS::UniString& rhinoPointGuid);
 	
+	// Find 128-bit rhinoPointGuid key of a hotspot (APINULLGuid if not mapped)
+	API_Guid FindRhinoKeyByHotspot(const API_Guid& hotspotGuid);
+	
+	// Convert rhinoPointGuid string to its 128-bit key (non-GUID ids are hashed)
+	API_Guid RhinoKeyFromString(const GS::UniString& rhinoPointGuid);
+	
 	// Get all hotspot GUIDs
 	GS::Array<API_Guid> GetAllHotspots();
 	
@@ -184,5 +527,45 @@ namespace HotspotManager {
 	void DeleteAllTrackedHotspots();
 }
 
+// -----------------------------------------------------------------------------
+// Global storage for created dimensions (one dimension per hotspot pair)
+// Hash-indexed: pair lookup and per-hotspot lookup are O(1)
+// -----------------------------------------------------------------------------
+
+namespace DimensionManager {
+	// Find tracked dimension for the hotspot pair (order doesn't matter)
+	API_Guid FindExistingDimension(const API_Guid& hotspot1, const API_Guid& hotspot2);
+	
+	// Register a new dimension for hotspot pair
+	void AddDimension(const API_Guid& hotspot1, const API_Guid& hotspot2, const API_Guid& dimensionGuid);
+	
+	// Find tracked chain dimension for the node sequence (either direction)
+	API_Guid FindExistingChain(const GS::Array<API_Guid>& hotspots);
+	
+	// Register a new chain dimension (one node per hotspot)
+	void AddDimensionChain(const GS::Array<API_Guid>& hotspots, const API_Guid& dimensionGuid);
+	
+	// Stop tracking a dimension
+	void RemoveDimension(const API_Guid& dimensionGuid);
+	
+	// Get all tracked dimension GUIDs (pairs and chains)
+	GS::Array<API_Guid> GetAllDimensions();
+	
+	// Check if dimension was created by this add-on
+	bool IsTrackedDimension(const API_Guid& dimensionGuid);
+	
+	// Get dimensions attached to a hotspot
+	GS::Array<API_Guid> GetDimensionsForHotspot(const API_Guid& hotspotGuid);
+	
+	// Get hotspots a dimension is attached to (pair or chain nodes)
+	GS::Array<API_Guid> GetHotspotsForDimension(const API_Guid& dimensionGuid);
+	
+	// Number of live dimensions attached to a hotspot
+	UInt32 GetReferenceCount(const API_Guid& hotspotGuid);
+	
+	// Clear all tracked dimensions
+	void ClearAllDimensions();
+}
+
 #endif // DIMENSIONCOMMANDS_HPP
 
@@ -5,70 +5,337 @@
 
 #include "DimensionHelper.hpp"
 #include "APICommon.h"
+#include "SpatialIndex.hpp"
+#include "UndoSession.hpp"
+#include "PlacementKernel.hpp"
+#include "DefaultsCache.hpp"
+#include "ElementTracker.hpp"
 #include <limits>
 #include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define DIMENSIONHELPER_SIMD_SSE2
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define DIMENSIONHELPER_SIMD_NEON
+	#include <arm_neon.h>
+#endif
 
 namespace DimensionHelper {
 
+	namespace {
+		// Hotspots of one element in structure-of-arrays layout (xs/ys feed the distance kernel)
+		struct ElementHotspots {
+			API_ElemType			type = {};
+			std::vector<double>		xs;
+			std::vector<double>		ys;
+			std::vector<API_Neig>	neigs;
+		};
+
+		constexpr UInt32 MaxCachedElements = 4096;
+
+		GS::HashTable<API_Guid, ElementHotspots> g_hotspotCache;
+
+		// Index of the point nearest to (x, y); squared distance returned in minDistSq
+		// No sqrt: callers compare against the squared tolerance
+		// Every path computes dx*dx + dy*dy (no fused multiply-add) and keeps the
+		// first of equal minimums, so all platforms pick the same point
+		Int32 FindNearestPoint(const double* xs, const double* ys, UInt32 count, double x, double y, double& minDistSq)
+		{
+			minDistSq = std::numeric_limits<double>::max();
+			Int32 nearestIdx = -1;
+			UInt32 i = 0;
+
+#if defined(DIMENSIONHELPER_SIMD_SSE2)
+			if (count >= 2) {
+				// Per-lane running minimum and its index (as double - exact below 2^53)
+				const __m128d px = _mm_set1_pd(x);
+				const __m128d py = _mm_set1_pd(y);
+				const __m128d step = _mm_set1_pd(2.0);
+				__m128d laneMin = _mm_set1_pd(minDistSq);
+				__m128d laneIdx = _mm_set1_pd(-1.0);
+				__m128d idx = _mm_set_pd(1.0, 0.0);
+				for (; i + 2 <= count; i += 2) {
+					const __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), px);
+					const __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), py);
+					const __m128d d = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+					const __m128d closer = _mm_cmplt_pd(d, laneMin);
+					laneMin = _mm_or_pd(_mm_and_pd(closer, d), _mm_andnot_pd(closer, laneMin));
+					laneIdx = _mm_or_pd(_mm_and_pd(closer, idx), _mm_andnot_pd(closer, laneIdx));
+					idx = _mm_add_pd(idx, step);
+				}
+				alignas(16) double mins[2];
+				alignas(16) double idxs[2];
+				_mm_store_pd(mins, laneMin);
+				_mm_store_pd(idxs, laneIdx);
+				// Lane 0 holds the even indices; on a tie the lower index wins
+				const int lane = (mins[1] < mins[0] || (mins[1] == mins[0] && idxs[1] >= 0.0 && (idxs[0] < 0.0 || idxs[1] < idxs[0]))) ? 1 : 0;
+				minDistSq = mins[lane];
+				nearestIdx = (Int32)idxs[lane];
+			}
+#elif defined(DIMENSIONHELPER_SIMD_NEON)
+			if (count >= 2) {
+				const float64x2_t px = vdupq_n_f64(x);
+				const float64x2_t py = vdupq_n_f64(y);
+				const float64x2_t step = vdupq_n_f64(2.0);
+				float64x2_t laneMin = vdupq_n_f64(minDistSq);
+				float64x2_t laneIdx = vdupq_n_f64(-1.0);
+				const double firstIdx[2] = { 0.0, 1.0 };
+				float64x2_t idx = vld1q_f64(firstIdx);
+				for (; i + 2 <= count; i += 2) {
+					const float64x2_t dx = vsubq_f64(vld1q_f64(xs + i), px);
+					const float64x2_t dy = vsubq_f64(vld1q_f64(ys + i), py);
+					const float64x2_t d = vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy));
+					const uint64x2_t closer = vcltq_f64(d, laneMin);
+					laneMin = vbslq_f64(closer, d, laneMin);
+					laneIdx = vbslq_f64(closer, idx, laneIdx);
+					idx = vaddq_f64(idx, step);
+				}
+				const double mins[2] = { vgetq_lane_f64(laneMin, 0), vgetq_lane_f64(laneMin, 1) };
+				const double idxs[2] = { vgetq_lane_f64(laneIdx, 0), vgetq_lane_f64(laneIdx, 1) };
+				const int lane = (mins[1] < mins[0] || (mins[1] == mins[0] && idxs[1] >= 0.0 && (idxs[0] < 0.0 || idxs[1] < idxs[0]))) ? 1 : 0;
+				minDistSq = mins[lane];
+				nearestIdx = (Int32)idxs[lane];
+			}
+#endif
+
+			for (; i < count; ++i) {
+				const double dx = xs[i] - x;
+				const double dy = ys[i] - y;
+				const double d = dx * dx + dy * dy;
+				if (d < minDistSq) { minDistSq = d; nearestIdx = (Int32)i; }
+			}
+			return nearestIdx;
+		}
+
+		// Node handle of the active DimElemPool (nullptr - allocate per dimension)
+		API_DimElem**	g_pooledDimElems = nullptr;
+		UInt32			g_pooledNodeCount = 0;
+		UInt32			g_poolDepth = 0;
+
+		// Zeroed node handle for nodeCount nodes; the pooled one is resized in place if needed
+		API_DimElem** AcquireDimElems(UInt32 nodeCount)
+		{
+			const GSSize size = (GSSize)(nodeCount * sizeof(API_DimElem));
+			if (g_poolDepth == 0) {
+				return reinterpret_cast<API_DimElem**>(BMAllocateHandle(size, ALLOCATE_CLEAR, 0));
+			}
+			if (g_pooledDimElems == nullptr) {
+				g_pooledDimElems = reinterpret_cast<API_DimElem**>(BMAllocateHandle(size, 0, 0));
+			} else if (g_pooledNodeCount != nodeCount) {
+				GSHandle resized = BMReallocHandle(reinterpret_cast<GSHandle>(g_pooledDimElems), size, 0, 0);
+				if (resized == nullptr) return nullptr; // the old handle stays with the pool
+				g_pooledDimElems = reinterpret_cast<API_DimElem**>(resized);
+			}
+			if (g_pooledDimElems == nullptr) return nullptr;
+
+			g_pooledNodeCount = nodeCount;
+			BNZeroMemory(*g_pooledDimElems, size);
+			return g_pooledDimElems;
+		}
+
+		// Dispose the memo, except for the pooled node handle
+		void ReleaseMemo(API_ElementMemo& memo)
+		{
+			if (memo.dimElems != nullptr && memo.dimElems == g_pooledDimElems) {
+				memo.dimElems = nullptr;
+			}
+			ACAPI_DisposeElemMemoHdls(&memo);
+		}
+
+		// Cached hotspots of an element; read from the database on first use
+		const ElementHotspots* GetElementHotspots(const API_Guid& elementGuid)
+		{
+			const ElementHotspots* cached = g_hotspotCache.GetPtr(elementGuid);
+			if (cached != nullptr) {
+				return cached;
+			}
+
+			API_Elem_Head header = {};
+			header.guid = elementGuid;
+			if (ACAPI_Element_GetHeader(&header) != NoError) {
+				return nullptr;
+			}
+
+			// Get element hotspots using ACAPI_Element_GetHotspots
+			// This returns hotspots that are already attached to the element
+			GS::Array<API_ElementHotspot> hotspotArray;
+			if (ACAPI_Element_GetHotspots(elementGuid, &hotspotArray) != NoError) {
+				return nullptr;
+			}
+
+			ElementHotspots entry;
+			entry.type = header.type;
+			entry.xs.reserve(hotspotArray.GetSize());
+			entry.ys.reserve(hotspotArray.GetSize());
+			entry.neigs.reserve(hotspotArray.GetSize());
+			for (UInt32 i = 0; i < hotspotArray.GetSize(); ++i) {
+				API_Neig neig;
+				API_Coord3D coord;
+				hotspotArray[i].Get(neig, coord);  // Get neig and coord from hotspot (as in Element_Snippets.cpp)
+				entry.xs.push_back(coord.x);
+				entry.ys.push_back(coord.y);
+				entry.neigs.push_back(neig);
+			}
+
+			// Unbounded growth is not worth it - the working set is the elements of the current solve
+			if (g_hotspotCache.GetSize() >= MaxCachedElements) {
+				ClearHotspotCache();
+			}
+			g_hotspotCache.Add(elementGuid, entry);
+			// Needed to hear about changes of the element and drop its entry
+			ElementTracker::Observe(elementGuid);
+			return g_hotspotCache.GetPtr(elementGuid);
+		}
+	}
+
 	// Helper function to find nearest hotspot on element by coordinate
-	// Returns true if found, and sets neig, coord, and elementType
-	// This matches the pattern from Element_Snippets.cpp where hotspotArray[i].Get(neig, coord) is used
-	static bool FindNearestHotspot(const API_Guid& elementGuid, const API_Coord& targetCoord, API_Neig& neig, API_Coord& hotspotCoord, API_ElemType& elementType)
+	// Returns true if found within snapTolerance, and sets neig, coord, and elementType
+	static bool FindNearestHotspot(const API_Guid& elementGuid, const API_Coord& targetCoord, double snapTolerance, API_Neig& neig, API_Coord& hotspotCoord, API_ElemType& elementType)
 	{
-		// Get element to determine its type
-		API_Element element = {};
-		element.header.guid = elementGuid;
-		if (ACAPI_Element_Get(&element) != NoError) {
+		const ElementHotspots* hotspots = GetElementHotspots(elementGuid);
+		if (hotspots == nullptr || hotspots->xs.empty()) {
 			return false;
 		}
-		elementType = element.header.type;
 
-		// Get element hotspots using ACAPI_Element_GetHotspots
-		// This returns hotspots that are already attached to the element
-		GS::Array<API_ElementHotspot> hotspotArray;
-		if (ACAPI_Element_GetHotspots(elementGuid, &hotspotArray) != NoError) {
+		double minDistSq = 0.0;
+		const Int32 nearestIdx = FindNearestPoint(hotspots->xs.data(), hotspots->ys.data(), (UInt32)hotspots->xs.size(),
+			targetCoord.x, targetCoord.y, minDistSq);
+
+		// Если ближайшая точка дальше допуска, не привязываемся
+		if (nearestIdx < 0 || minDistSq > snapTolerance * snapTolerance) {
 			return false;
 		}
 
-		if (hotspotArray.IsEmpty()) {
-			return false;
+		// Return the neig and coord from the nearest hotspot
+		elementType = hotspots->type;
+		neig = hotspots->neigs[nearestIdx];
+		hotspotCoord.x = hotspots->xs[nearestIdx];
+		hotspotCoord.y = hotspots->ys[nearestIdx];
+		return true;
+	}
+
+	void OnElementEvent(const API_NotifyElementType& elemEvent)
+	{
+		switch (elemEvent.notifID) {
+			case APINotifyElement_New:
+			case APINotifyElement_Copy:
+				// Not cached yet
+				break;
+
+			default:
+				// Change, delete, undo/redo: hotspots may have moved
+				if (g_hotspotCache.ContainsKey(elemEvent.elemHead.guid)) {
+					g_hotspotCache.Delete(elemEvent.elemHead.guid);
+					ElementTracker::Unobserve(elemEvent.elemHead.guid);
+				}
+				break;
 		}
+	}
+
+	void ClearHotspotCache()
+	{
+		for (auto it = g_hotspotCache.Begin(); it != g_hotspotCache.End(); ++it) {
+			ElementTracker::Unobserve(it->key);
+		}
+		g_hotspotCache.Clear();
+	}
+
+	// Fill one dimension node
+	// Priority 1: attach to hotspot element, priority 2: attach to nearest hotspot of element, otherwise coordinates only
+	static void SetupDimElem(API_DimElem& e, const API_Coord& pt, const API_Guid* hotspotGuid, const API_Guid* elementGuid, double refY, double snapTolerance)
+	{
+		e.base.base.line = false;
+		e.base.base.special = false;
 
-		// Find nearest hotspot - use the same pattern as Element_Snippets.cpp
-		double minDist = std::numeric_limits<double>::max();
-		Int32 nearestIdx = -1;
-		API_Neig nearestNeig = {};
-		API_Coord nearestCoord = {};
-
-		for (Int32 i = 0; i < (Int32)hotspotArray.GetSize(); ++i) {
-			API_Neig currentNeig;
-			API_Coord3D coord;
-			hotspotArray[i].Get(currentNeig, coord);  // Get neig and coord from hotspot
-			
-			double dx = coord.x - targetCoord.x;
-			double dy = coord.y - targetCoord.y;
-			double dist = std::hypot(dx, dy);
-			if (dist < minDist) {
-				minDist = dist;
-				nearestIdx = i;
-				nearestNeig = currentNeig;  // Save the entire neig structure
-				nearestCoord.x = coord.x;
-				nearestCoord.y = coord.y;
+		// Priority 1: Try to attach to hotspot element if hotspot GUID provided
+		if (hotspotGuid != nullptr && *hotspotGuid != APINULLGuid) {
+			API_Coord hotspotPos = {};
+			if (SpatialIndex::GetHotspotPosition(*hotspotGuid, hotspotPos)) {
+				// Привязываемся к hotspot элементу напрямую
+				e.base.loc = hotspotPos;  // Координата из hotspot элемента
+				e.base.base.type = API_HotspotID;  // Тип - hotspot элемент
+				e.base.base.guid = *hotspotGuid;  // GUID hotspot элемента
+				e.base.base.inIndex = 0;  // Для hotspot элементов обычно 0
+				// pos устанавливается после base.loc
+				e.pos.x = e.base.loc.x;
+				e.pos.y = refY;  // Y берется из refC
+				return;
+			}
+		}
+		// Priority 2: Try to attach to element if element GUID provided (fallback)
+		else if (elementGuid != nullptr && *elementGuid != APINULLGuid) {
+			API_Neig neig = {};
+			API_Coord hotspotCoord = {};
+			API_ElemType elementType = {};
+			if (FindNearestHotspot(*elementGuid, pt, snapTolerance, neig, hotspotCoord, elementType)) {
+				// Привязываемся к элементу - используем данные из hotspot (как в примере)
+				e.base.loc = hotspotCoord;  // Координата из hotspot
+				e.base.base.type = elementType;
+				e.base.base.guid = *elementGuid;  // GUID элемента (instance GUID)
+				e.base.base.inIndex = neig.inIndex;  // inIndex из neig (как в примере)
+				// pos устанавливается после base.loc, как в примере
+				e.pos.x = e.base.loc.x;
+				e.pos.y = refY;  // Y берется из refC, как в примере
+				return;
 			}
 		}
 
-		// Если ближайшая точка дальше 10 см, не привязываемся
-		if (nearestIdx < 0 || minDist > 0.1) {
-			return false;
+		// Не удалось найти точку привязки (или она не задана) - используем только координаты
+		e.base.loc = pt;
+		e.pos = pt;
+	}
+
+	LinePlacement ComputeLinePlacement(const API_Coord& pt1, const API_Coord& pt2, double offset)
+	{
+		// Same kernel as the batch commands, so a pair is placed identically either way
+		double dirX = 0.0, dirY = 0.0, perpX = 0.0, perpY = 0.0, refX = 0.0, refY = 0.0, length = 0.0;
+		unsigned char degenerate = 1;
+		PlacementKernel::LineInputs in;
+		in.x1 = &pt1.x;
+		in.y1 = &pt1.y;
+		in.x2 = &pt2.x;
+		in.y2 = &pt2.y;
+		in.offset = &offset;
+		PlacementKernel::LinePlacements out;
+		out.dirX = &dirX;
+		out.dirY = &dirY;
+		out.perpX = &perpX;
+		out.perpY = &perpY;
+		out.refX = &refX;
+		out.refY = &refY;
+		out.length = &length;
+		out.degenerate = &degenerate;
+		PlacementKernel::ComputePlacements(in, out, 1);
+
+		LinePlacement placement;
+		placement.refC.x = refX;
+		placement.refC.y = refY;
+		placement.direction.x = dirX;   // направление A→B
+		placement.direction.y = dirY;
+		placement.length = length;
+		placement.degenerate = (degenerate != 0);
+		return placement;
+	}
+
+	DimElemPool::DimElemPool(UInt32 maxNodeCount)
+	{
+		// Nested pools share the outer handle
+		if (g_poolDepth++ == 0 && maxNodeCount > 0) {
+			AcquireDimElems(maxNodeCount);
 		}
+	}
 
-		// Return the neig and coord from the nearest hotspot
-		neig = nearestNeig;
-		hotspotCoord = nearestCoord;
-		return true;
+	DimElemPool::~DimElemPool()
+	{
+		if (--g_poolDepth == 0 && g_pooledDimElems != nullptr) {
+			BMKillHandle(reinterpret_cast<GSHandle*>(&g_pooledDimElems));
+			g_pooledNodeCount = 0;
+		}
 	}
 
-	bool CreateLinearDimension(
+	bool CreateLinearDimensionInUndoScope(
 		const API_Coord& pt1,
 		const API_Coord& pt2,
 		API_Guid* outDimensionGuid,
@@ -79,183 +346,135 @@ namespace DimensionHelper {
 		const GS::UniString& /*layerName*/,
 		const GS::UniString& /*styleName*/,
 		const GS::UniString& /*textOverride*/,
-		double offset)
+		double offset,
+		double snapTolerance,
+		const LinePlacement* placement)
 	{
-		const double dx = pt2.x - pt1.x;
-		const double dy = pt2.y - pt1.y;
-		const double len = std::hypot(dx, dy);
-		if (len < 1e-6) return false; // точки совпали
-
-		API_Element dim = {};
-		dim.header.type = API_DimensionID;
+		const LinePlacement line = (placement != nullptr) ? *placement : ComputeLinePlacement(pt1, pt2, offset);
+		if (line.degenerate) return false; // точки совпали
 
 		// Get defaults - this will use last used dimension properties (style, colors, arrows, etc.)
-		GSErrCode err = ACAPI_Element_GetDefaults(&dim, nullptr);
+		// Copied from the cached template; read from the database only after the defaults changed
+		API_Element dim;
+		GSErrCode err = DefaultsCache::GetDefaults(API_DimensionID, dim);
 		if (err != NoError) return false;
 
 		// Only set the geometry (base line and direction) - keep all other properties from defaults
-		// Базовая линия проходит через A и B
-		dim.dimension.refC.x = pt1.x;
-		dim.dimension.refC.y = pt1.y;
-		dim.dimension.direction.x = dx;   // направление A→B
-		dim.dimension.direction.y = dy;
-		
-		// Apply offset if specified (perpendicular to dimension direction)
-		// Offset is applied to the dimension line position (refC)
-		// Perpendicular vector to direction (dx, dy) is (-dy, dx) normalized
-		if (std::abs(offset) > 1e-6) {
-			double dirLen = len;
-			if (dirLen > 1e-6) {
-				// Normalized perpendicular vector
-				double perpX = -dy / dirLen;
-				double perpY = dx / dirLen;
-				// Apply offset to refC
-				dim.dimension.refC.x += perpX * offset;
-				dim.dimension.refC.y += perpY * offset;
-			}
-		}
+		dim.dimension.refC = line.refC;
+		dim.dimension.direction = line.direction;
 
 		// Узлы размерной цепочки: кладём ТУДА ЖЕ, без проекций
 		API_ElementMemo memo = {};
 		BNZeroMemory(&memo, sizeof(API_ElementMemo));
 		dim.dimension.nDimElem = 2;
 
-		memo.dimElems = reinterpret_cast<API_DimElem**>(
-			BMAllocateHandle(2 * sizeof(API_DimElem), ALLOCATE_CLEAR, 0)
-		);
+		memo.dimElems = AcquireDimElems(2);
 		if (memo.dimElems == nullptr) return false;
 
-		API_DimElem& e1 = (*memo.dimElems)[0];
-		
-		// Priority 1: Try to attach to hotspot element if hotspot GUID provided
-		if (hotspotGuid1 != nullptr && *hotspotGuid1 != APINULLGuid) {
-			// Get hotspot element
-			API_Element hotspot = {};
-			hotspot.header.guid = *hotspotGuid1;
-			if (ACAPI_Element_Get(&hotspot) == NoError && hotspot.header.type == API_HotspotID) {
-				// Привязываемся к hotspot элементу напрямую
-				e1.base.loc = hotspot.hotspot.pos;  // Координата из hotspot элемента
-				e1.base.base.type = API_HotspotID;  // Тип - hotspot элемент
-				e1.base.base.guid = *hotspotGuid1;  // GUID hotspot элемента
-				e1.base.base.inIndex = 0;  // Для hotspot элементов обычно 0
-				e1.base.base.line = false;
-				e1.base.base.special = false;
-				// pos устанавливается после base.loc
-				e1.pos.x = e1.base.loc.x;
-				e1.pos.y = dim.dimension.refC.y;  // Y берется из refC
-			} else {
-				// Hotspot не найден - используем только координаты
-				e1.base.loc = pt1;
-				e1.base.base.line = false;
-				e1.base.base.special = false;
-				e1.pos = pt1;
-			}
-		}
-		// Priority 2: Try to attach to element if element GUID provided (fallback)
-		else if (elementGuid1 != nullptr && *elementGuid1 != APINULLGuid) {
-			API_Neig neig = {};
-			API_Coord hotspotCoord = {};
-			API_ElemType elementType = {};
-			if (FindNearestHotspot(*elementGuid1, pt1, neig, hotspotCoord, elementType)) {
-				// Привязываемся к элементу - используем данные из hotspot (как в примере)
-				e1.base.loc = hotspotCoord;  // Координата из hotspot
-				e1.base.base.type = elementType;
-				e1.base.base.guid = *elementGuid1;  // GUID элемента (instance GUID)
-				e1.base.base.inIndex = neig.inIndex;  // inIndex из neig (как в примере)
-				e1.base.base.line = false;
-				e1.base.base.special = false;
-				// pos устанавливается после base.loc, как в примере
-				e1.pos.x = e1.base.loc.x;
-				e1.pos.y = dim.dimension.refC.y;  // Y берется из refC, как в примере
-			} else {
-				// Не удалось найти точку привязки - используем только координаты
-				e1.base.loc = pt1;
-				e1.base.base.line = false;
-				e1.base.base.special = false;
-				e1.pos = pt1;
-			}
-		} else {
-			// No attachment - just coordinates
-			e1.base.loc = pt1;
-			e1.base.base.line = false;
-			e1.base.base.special = false;
-			e1.pos = pt1;
-		}
+		SetupDimElem((*memo.dimElems)[0], pt1, hotspotGuid1, elementGuid1, dim.dimension.refC.y, snapTolerance);
+		SetupDimElem((*memo.dimElems)[1], pt2, hotspotGuid2, elementGuid2, dim.dimension.refC.y, snapTolerance);
 
-		API_DimElem& e2 = (*memo.dimElems)[1];
+		err = ACAPI_Element_Create(&dim, &memo);
+		if (err != NoError) {
+			// Log error for debugging
+			ACAPI_WriteReport("DimensionHelper::CreateLinearDimension failed with error: %d", false, err);
+		} else if (outDimensionGuid != nullptr) {
+			// Return created dimension GUID
+			*outDimensionGuid = dim.header.guid;
+		}
 		
-		// Priority 1: Try to attach to hotspot element if hotspot GUID provided
-		if (hotspotGuid2 != nullptr && *hotspotGuid2 != APINULLGuid) {
-			// Get hotspot element
-			API_Element hotspot = {};
-			hotspot.header.guid = *hotspotGuid2;
-			if (ACAPI_Element_Get(&hotspot) == NoError && hotspot.header.type == API_HotspotID) {
-				// Привязываемся к hotspot элементу напрямую
-				e2.base.loc = hotspot.hotspot.pos;  // Координата из hotspot элемента
-				e2.base.base.type = API_HotspotID;  // Тип - hotspot элемент
-				e2.base.base.guid = *hotspotGuid2;  // GUID hotspot элемента
-				e2.base.base.inIndex = 0;  // Для hotspot элементов обычно 0
-				e2.base.base.line = false;
-				e2.base.base.special = false;
-				// pos устанавливается после base.loc
-				e2.pos.x = e2.base.loc.x;
-				e2.pos.y = dim.dimension.refC.y;  // Y берется из refC
-			} else {
-				// Hotspot не найден - используем только координаты
-				e2.base.loc = pt2;
-				e2.base.base.line = false;
-				e2.base.base.special = false;
-				e2.pos = pt2;
-			}
+		ReleaseMemo(memo);
+
+		return (err == NoError);
+	}
+
+	bool CreateLinearDimension(
+		const API_Coord& pt1,
+		const API_Coord& pt2,
+		API_Guid* outDimensionGuid,
+		const API_Guid* hotspotGuid1,
+		const API_Guid* hotspotGuid2,
+		const API_Guid* elementGuid1,
+		const API_Guid* elementGuid2,
+		const GS::UniString& layerName,
+		const GS::UniString& styleName,
+		const GS::UniString& textOverride,
+		double offset,
+		double snapTolerance)
+	{
+		// Use ACAPI_CallUndoableCommand (via UndoSession) for proper undo support
+		bool created = false;
+		GSErrCode err = UndoSession::RunUndoable("CreateLinearDimension", [&]() -> GSErrCode {
+			created = CreateLinearDimensionInUndoScope(pt1, pt2, outDimensionGuid, hotspotGuid1, hotspotGuid2,
+				elementGuid1, elementGuid2, layerName, styleName, textOverride, offset, snapTolerance);
+			return created ? NoError : APIERR_GENERAL;
+		});
+
+		return (err == NoError && created);
+	}
+
+	bool CreateDimensionChainInUndoScope(
+		const GS::Array<API_Coord>& points,
+		const GS::Array<API_Guid>& hotspotGuids,
+		API_Guid* outDimensionGuid,
+		double offset)
+	{
+		const UInt32 nodeCount = points.GetSize();
+		if (nodeCount < 2) return false;
+		if (!hotspotGuids.IsEmpty() && hotspotGuids.GetSize() != nodeCount) return false;
+
+		// Dimension line runs from the first to the last point
+		const LinePlacement line = ComputeLinePlacement(points[0], points[nodeCount - 1], offset);
+		if (line.degenerate) return false; // крайние точки совпали
+
+		// Get defaults - this will use last used dimension properties (style, colors, arrows, etc.)
+		// Copied from the cached template; read from the database only after the defaults changed
+		API_Element dim;
+		GSErrCode err = DefaultsCache::GetDefaults(API_DimensionID, dim);
+		if (err != NoError) return false;
+
+		dim.dimension.refC = line.refC;
+		dim.dimension.direction = line.direction;
+
+		// One node per point - a single element instead of K-1 two-node dimensions
+		API_ElementMemo memo = {};
+		BNZeroMemory(&memo, sizeof(API_ElementMemo));
+		dim.dimension.nDimElem = (Int32)nodeCount;
+
+		memo.dimElems = AcquireDimElems(nodeCount);
+		if (memo.dimElems == nullptr) return false;
+
+		for (UInt32 i = 0; i < nodeCount; ++i) {
+			const API_Guid* hotspotGuid = hotspotGuids.IsEmpty() ? nullptr : &hotspotGuids[i];
+			SetupDimElem((*memo.dimElems)[i], points[i], hotspotGuid, nullptr, dim.dimension.refC.y, DefaultSnapTolerance);
 		}
-		// Priority 2: Try to attach to element if element GUID provided (fallback)
-		else if (elementGuid2 != nullptr && *elementGuid2 != APINULLGuid) {
-			API_Neig neig = {};
-			API_Coord hotspotCoord = {};
-			API_ElemType elementType = {};
-			if (FindNearestHotspot(*elementGuid2, pt2, neig, hotspotCoord, elementType)) {
-				// Привязываемся к элементу - используем данные из hotspot (как в примере)
-				e2.base.loc = hotspotCoord;  // Координата из hotspot
-				e2.base.base.type = elementType;
-				e2.base.base.guid = *elementGuid2;  // GUID элемента (instance GUID)
-				e2.base.base.inIndex = neig.inIndex;  // inIndex из neig (как в примере)
-				e2.base.base.line = false;
-				e2.base.base.special = false;
-				// pos устанавливается после base.loc, как в примере
-				e2.pos.x = e2.base.loc.x;
-				e2.pos.y = dim.dimension.refC.y;  // Y берется из refC, как в примере
-			} else {
-				// Не удалось найти точку привязки - используем только координаты
-				e2.base.loc = pt2;
-				e2.base.base.line = false;
-				e2.base.base.special = false;
-				e2.pos = pt2;
-			}
-		} else {
-			// No attachment - just coordinates
-			e2.base.loc = pt2;
-			e2.base.base.line = false;
-			e2.base.base.special = false;
-			e2.pos = pt2;
+
+		err = ACAPI_Element_Create(&dim, &memo);
+		if (err != NoError) {
+			ACAPI_WriteReport("DimensionHelper::CreateDimensionChain failed with error: %d", false, err);
+		} else if (outDimensionGuid != nullptr) {
+			*outDimensionGuid = dim.header.guid;
 		}
 
-		// Use ACAPI_CallUndoableCommand for proper undo support
-		err = ACAPI_CallUndoableCommand("CreateLinearDimension", [&]() -> GSErrCode {
-			GSErrCode createErr = ACAPI_Element_Create(&dim, &memo);
-			if (createErr != NoError) {
-				// Log error for debugging
-				ACAPI_WriteReport("DimensionHelper::CreateLinearDimension failed with error: %d", false, createErr);
-			} else if (outDimensionGuid != nullptr) {
-				// Return created dimension GUID
-				*outDimensionGuid = dim.header.guid;
-			}
-			return createErr;
-		});
-		
-		ACAPI_DisposeElemMemoHdls(&memo);
+		ReleaseMemo(memo);
 
 		return (err == NoError);
 	}
 
+	bool CreateDimensionChain(
+		const GS::Array<API_Coord>& points,
+		const GS::Array<API_Guid>& hotspotGuids,
+		API_Guid* outDimensionGuid,
+		double offset)
+	{
+		bool created = false;
+		GSErrCode err = UndoSession::RunUndoable("CreateDimensionChain", [&]() -> GSErrCode {
+			created = CreateDimensionChainInUndoScope(points, hotspotGuids, outDimensionGuid, offset);
+			return created ? NoError : APIERR_GENERAL;
+		});
+
+		return (err == NoError && created);
+	}
+
 } // namespace DimensionHelper
 
@@ -10,6 +10,22 @@
 
 namespace DimensionHelper {
 
+	// Default max distance between a requested point and an element hotspot it snaps to
+	constexpr double DefaultSnapTolerance = 0.1;
+
+	// -----------------------------------------------------------------------------
+	// Base line of a two-point dimension: direction pt1->pt2, refC shifted
+	// perpendicular by offset. Pure geometry (no ACAPI) - safe on any thread
+	// -----------------------------------------------------------------------------
+	struct LinePlacement {
+		API_Coord	refC = {};
+		API_Coord	direction = {};		// pt2 - pt1, not normalized
+		double		length = 0.0;
+		bool		degenerate = true;	// points closer than 1e-6
+	};
+
+	LinePlacement ComputeLinePlacement(const API_Coord& pt1, const API_Coord& pt2, double offset);
+
 	// -----------------------------------------------------------------------------
 	// Create linear dimension between two points
 	// Optionally attach to hotspot elements by GUID (preferred) or to elements by GUID (fallback)
@@ -26,9 +42,73 @@ namespace DimensionHelper {
 		const GS::UniString& layerName = GS::EmptyUniString,
 		const GS::UniString& styleName = GS::EmptyUniString,
 		const GS::UniString& textOverride = GS::EmptyUniString,
-		double offset = 0.0  // Optional: dimension line offset distance (perpendicular to dimension direction)
+		double offset = 0.0,  // Optional: dimension line offset distance (perpendicular to dimension direction)
+		double snapTolerance = DefaultSnapTolerance  // Optional: max distance to an element hotspot for the fallback attachment
+	);
+
+	// -----------------------------------------------------------------------------
+	// Same as CreateLinearDimension, but without its own undo step
+	// Must be called from inside ACAPI_CallUndoableCommand (used by batch commands
+	// to create many dimensions in a single undo step)
+	// -----------------------------------------------------------------------------
+	bool CreateLinearDimensionInUndoScope(
+		const API_Coord& pt1,
+		const API_Coord& pt2,
+		API_Guid* outDimensionGuid,
+		const API_Guid* hotspotGuid1 = nullptr,
+		const API_Guid* hotspotGuid2 = nullptr,
+		const API_Guid* elementGuid1 = nullptr,
+		const API_Guid* elementGuid2 = nullptr,
+		const GS::UniString& layerName = GS::EmptyUniString,
+		const GS::UniString& styleName = GS::EmptyUniString,
+		const GS::UniString& textOverride = GS::EmptyUniString,
+		double offset = 0.0,
+		double snapTolerance = DefaultSnapTolerance,
+		const LinePlacement* placement = nullptr  // Optional: precomputed by ComputeLinePlacement (offset is then ignored)
 	);
 
+	// -----------------------------------------------------------------------------
+	// Create one dimension with a node per point (K points -> 1 element with K nodes)
+	// hotspotGuids is either empty or parallel to points; APINULLGuid entries stay unattached
+	// The dimension line runs from the first to the last point
+	// -----------------------------------------------------------------------------
+	bool CreateDimensionChain(
+		const GS::Array<API_Coord>& points,
+		const GS::Array<API_Guid>& hotspotGuids,
+		API_Guid* outDimensionGuid,
+		double offset = 0.0
+	);
+
+	// Same as CreateDimensionChain, but without its own undo step
+	bool CreateDimensionChainInUndoScope(
+		const GS::Array<API_Coord>& points,
+		const GS::Array<API_Guid>& hotspotGuids,
+		API_Guid* outDimensionGuid,
+		double offset = 0.0
+	);
+
+	// -----------------------------------------------------------------------------
+	// Dimension node buffer shared by a batch
+	// While an instance is alive, the *InUndoScope creators refill one handle
+	// instead of allocating and disposing a node handle per dimension; it is
+	// allocated once for maxNodeCount nodes (the largest dimension of the batch)
+	// -----------------------------------------------------------------------------
+	class DimElemPool {
+	public:
+		explicit DimElemPool(UInt32 maxNodeCount);
+		~DimElemPool();
+
+		DimElemPool(const DimElemPool&) = delete;
+		DimElemPool& operator=(const DimElemPool&) = delete;
+	};
+
+	// -----------------------------------------------------------------------------
+	// Element hotspot cache used for the element attachment fallback
+	// Forward element notifications so cached hotspots of changed elements are dropped
+	// -----------------------------------------------------------------------------
+	void OnElementEvent(const API_NotifyElementType& elemEvent);
+	void ClearHotspotCache();
+
 } // namespace DimensionHelper
 
 #endif // DIMENSIONHELPER_HPP
@@ -0,0 +1,239 @@
+// *****************************************************************************
+// Source code for DimensionSets module (named sets of hotspots and dimensions)
+// *****************************************************************************
+
+#include "DimensionSets.hpp"
+#include "HotspotSweeper.hpp"
+#include "TrackingStore.hpp"
+
+namespace DimensionSets {
+
+	namespace {
+		GS::HashTable<GS::UniString, Members>					g_sets;
+		GS::HashTable<API_Guid, GS::Array<GS::UniString>>		g_hotspotOwners;		// hotspot -> sets containing it
+		GS::HashTable<API_Guid, GS::Array<GS::UniString>>		g_dimensionOwners;		// dimension -> sets containing it
+
+		void AddOwner (GS::HashTable<API_Guid, GS::Array<GS::UniString>>& owners, const API_Guid& guid, const GS::UniString& setId)
+		{
+			GS::Array<GS::UniString>* setIds = owners.GetPtr (guid);
+			if (setIds == nullptr) {
+				owners.Add (guid, GS::Array<GS::UniString> ());
+				setIds = owners.GetPtr (guid);
+			}
+			if (!setIds->Contains (setId)) {
+				setIds->Push (setId);
+			}
+		}
+
+		void RemoveOwner (GS::HashTable<API_Guid, GS::Array<GS::UniString>>& owners, const API_Guid& guid, const GS::UniString& setId)
+		{
+			GS::Array<GS::UniString>* setIds = owners.GetPtr (guid);
+			if (setIds == nullptr) {
+				return;
+			}
+			for (UIndex i = 0; i < setIds->GetSize (); ++i) {
+				if ((*setIds)[i] == setId) {
+					// Owner order is irrelevant - swap with last
+					(*setIds)[i] = setIds->GetLast ();
+					setIds->DeleteLast ();
+					break;
+				}
+			}
+			if (setIds->IsEmpty ()) {
+				owners.Delete (guid);
+			}
+		}
+
+		bool HasOtherOwner (const GS::HashTable<API_Guid, GS::Array<GS::UniString>>& owners, const API_Guid& guid, const GS::UniString& setId)
+		{
+			const GS::Array<GS::UniString>* setIds = owners.GetPtr (guid);
+			if (setIds == nullptr) {
+				return false;
+			}
+			for (const GS::UniString& ownerId : *setIds) {
+				if (ownerId != setId) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		Members& GetOrAdd (const GS::UniString& setId)
+		{
+			Members* members = g_sets.GetPtr (setId);
+			if (members == nullptr) {
+				g_sets.Add (setId, Members ());
+				members = g_sets.GetPtr (setId);
+			}
+			return *members;
+		}
+
+		// Forget a set without looking at what it releases; returns its hotspots
+		GS::HashSet<API_Guid> RemoveSet (const GS::UniString& setId)
+		{
+			const Members* members = g_sets.GetPtr (setId);
+			if (members == nullptr) {
+				return GS::HashSet<API_Guid> ();
+			}
+			GS::HashSet<API_Guid> hotspots = members->hotspots;
+			for (const API_Guid& hotspotGuid : members->hotspots) {
+				RemoveOwner (g_hotspotOwners, hotspotGuid, setId);
+			}
+			for (const API_Guid& dimensionGuid : members->dimensions) {
+				RemoveOwner (g_dimensionOwners, dimensionGuid, setId);
+			}
+			g_sets.Delete (setId);
+			TrackingStore::MarkSetDirty (setId);
+			return hotspots;
+		}
+
+		// A hotspot no set owns any more may be garbage (see HotspotSweeper)
+		void ReleaseHotspots (const GS::HashSet<API_Guid>& hotspots)
+		{
+			for (const API_Guid& hotspotGuid : hotspots) {
+				if (!g_hotspotOwners.ContainsKey (hotspotGuid)) {
+					HotspotSweeper::MarkCandidate (hotspotGuid);
+				}
+			}
+		}
+
+		void DropIfEmpty (const GS::UniString& setId)
+		{
+			const Members* members = g_sets.GetPtr (setId);
+			if (members != nullptr && members->hotspots.IsEmpty () && members->dimensions.IsEmpty ()) {
+				g_sets.Delete (setId);
+			}
+		}
+	}
+
+	const Members* Get (const GS::UniString& setId)
+	{
+		TrackingStore::EnsureLoaded ();
+		return g_sets.GetPtr (setId);
+	}
+
+	GS::Array<GS::UniString> GetSetIds ()
+	{
+		TrackingStore::EnsureLoaded ();
+		GS::Array<GS::UniString> setIds;
+		setIds.SetCapacity (g_sets.GetSize ());
+		for (auto it = g_sets.Begin (); it != g_sets.End (); ++it) {
+			setIds.Push (it->key);
+		}
+		return setIds;
+	}
+
+	void Replace (const GS::UniString& setId, const Members& members)
+	{
+		TrackingStore::EnsureLoaded ();
+		const GS::HashSet<API_Guid> previousHotspots = RemoveSet (setId);
+		if (!members.hotspots.IsEmpty () || !members.dimensions.IsEmpty ()) {
+			g_sets.Add (setId, members);
+			TrackingStore::MarkSetDirty (setId);
+			for (const API_Guid& hotspotGuid : members.hotspots) {
+				AddOwner (g_hotspotOwners, hotspotGuid, setId);
+			}
+			for (const API_Guid& dimensionGuid : members.dimensions) {
+				AddOwner (g_dimensionOwners, dimensionGuid, setId);
+			}
+		}
+		ReleaseHotspots (previousHotspots);
+	}
+
+	void AddHotspot (const GS::UniString& setId, const API_Guid& hotspotGuid)
+	{
+		if (hotspotGuid == APINULLGuid) {
+			return;
+		}
+		TrackingStore::EnsureLoaded ();
+		Members& members = GetOrAdd (setId);
+		if (!members.hotspots.Contains (hotspotGuid)) {
+			TrackingStore::MarkSetDirty (setId);
+			members.hotspots.Add (hotspotGuid);
+			AddOwner (g_hotspotOwners, hotspotGuid, setId);
+		}
+	}
+
+	void AddDimension (const GS::UniString& setId, const API_Guid& dimensionGuid)
+	{
+		if (dimensionGuid == APINULLGuid) {
+			return;
+		}
+		TrackingStore::EnsureLoaded ();
+		Members& members = GetOrAdd (setId);
+		if (!members.dimensions.Contains (dimensionGuid)) {
+			TrackingStore::MarkSetDirty (setId);
+			members.dimensions.Add (dimensionGuid);
+			AddOwner (g_dimensionOwners, dimensionGuid, setId);
+		}
+	}
+
+	void Remove (const GS::UniString& setId)
+	{
+		TrackingStore::EnsureLoaded ();
+		ReleaseHotspots (RemoveSet (setId));
+	}
+
+	bool IsHotspotInOtherSet (const GS::UniString& setId, const API_Guid& hotspotGuid)
+	{
+		TrackingStore::EnsureLoaded ();
+		return HasOtherOwner (g_hotspotOwners, hotspotGuid, setId);
+	}
+
+	bool IsDimensionInOtherSet (const GS::UniString& setId, const API_Guid& dimensionGuid)
+	{
+		TrackingStore::EnsureLoaded ();
+		return HasOtherOwner (g_dimensionOwners, dimensionGuid, setId);
+	}
+
+	bool ContainsHotspot (const API_Guid& hotspotGuid)
+	{
+		TrackingStore::EnsureLoaded ();
+		return g_hotspotOwners.ContainsKey (hotspotGuid);
+	}
+
+	void ForgetHotspot (const API_Guid& hotspotGuid)
+	{
+		const GS::Array<GS::UniString>* setIdsPtr = g_hotspotOwners.GetPtr (hotspotGuid);
+		if (setIdsPtr == nullptr) {
+			return;
+		}
+		const GS::Array<GS::UniString> setIds = *setIdsPtr;
+		g_hotspotOwners.Delete (hotspotGuid);
+		for (const GS::UniString& setId : setIds) {
+			TrackingStore::MarkSetDirty (setId);
+			Members* members = g_sets.GetPtr (setId);
+			if (members != nullptr) {
+				members->hotspots.Delete (hotspotGuid);
+				DropIfEmpty (setId);
+			}
+		}
+	}
+
+	void ForgetDimension (const API_Guid& dimensionGuid)
+	{
+		const GS::Array<GS::UniString>* setIdsPtr = g_dimensionOwners.GetPtr (dimensionGuid);
+		if (setIdsPtr == nullptr) {
+			return;
+		}
+		const GS::Array<GS::UniString> setIds = *setIdsPtr;
+		g_dimensionOwners.Delete (dimensionGuid);
+		for (const GS::UniString& setId : setIds) {
+			TrackingStore::MarkSetDirty (setId);
+			Members* members = g_sets.GetPtr (setId);
+			if (members != nullptr) {
+				members->dimensions.Delete (dimensionGuid);
+				DropIfEmpty (setId);
+			}
+		}
+	}
+
+	void Clear ()
+	{
+		g_sets.Clear ();
+		g_hotspotOwners.Clear ();
+		g_dimensionOwners.Clear ();
+		TrackingStore::MarkAllDirty ();
+	}
+
+} // namespace DimensionSets
@@ -0,0 +1,60 @@
+// *****************************************************************************
+// Header file for DimensionSets module (named sets of hotspots and dimensions)
+// *****************************************************************************
+
+#ifndef DIMENSIONSETS_HPP
+#define DIMENSIONSETS_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// A set is keyed by a client-provided ID (typically one Grasshopper component)
+// and owns the hotspots and dimensions produced for it. Membership is kept in
+// both directions (set -> members, element -> sets), so every operation costs
+// O(size of the set) or O(1) and never walks the other sets.
+//
+// An element may belong to several sets (two components dimensioning the
+// same point); it is deleted from the project only by its last owner.
+// -----------------------------------------------------------------------------
+
+namespace DimensionSets {
+
+	struct Members {
+		GS::HashSet<API_Guid>	hotspots;
+		GS::HashSet<API_Guid>	dimensions;
+	};
+
+	// Members of a set, nullptr if the set is unknown
+	const Members*				Get (const GS::UniString& setId);
+
+	// IDs of all non-empty sets
+	GS::Array<GS::UniString>	GetSetIds ();
+
+	// Make the set contain exactly the given members - O(old + new size)
+	void		Replace (const GS::UniString& setId, const Members& members);
+
+	// Add one member to a set (created if needed)
+	void		AddHotspot (const GS::UniString& setId, const API_Guid& hotspotGuid);
+	void		AddDimension (const GS::UniString& setId, const API_Guid& dimensionGuid);
+
+	// Forget a set; its elements stay in the project
+	void		Remove (const GS::UniString& setId);
+
+	// True if a set other than setId also owns the element
+	bool		IsHotspotInOtherSet (const GS::UniString& setId, const API_Guid& hotspotGuid);
+	bool		IsDimensionInOtherSet (const GS::UniString& setId, const API_Guid& dimensionGuid);
+
+	// True if any set owns the hotspot (a set membership is a reference, see HotspotSweeper)
+	bool		ContainsHotspot (const API_Guid& hotspotGuid);
+
+	// The element is gone - drop it from every set that owns it
+	void		ForgetHotspot (const API_Guid& hotspotGuid);
+	void		ForgetDimension (const API_Guid& dimensionGuid);
+
+	// Sets belong to one project - cleared on project switch by TrackingStore
+	void		Clear ();
+
+} // namespace DimensionSets
+
+#endif // DIMENSIONSETS_HPP
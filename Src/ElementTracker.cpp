@@ -0,0 +1,206 @@
+// *****************************************************************************
+// Source code for ElementTracker module (notification-driven validity cache)
+// *****************************************************************************
+
+#include "ElementTracker.hpp"
+#include "SpatialIndex.hpp"
+#include "DimensionHelper.hpp"
+#include "ChangeFeed.hpp"
+#include "HotspotSweeper.hpp"
+#include "TrackingStore.hpp"
+
+namespace ElementTracker {
+
+	namespace {
+		struct Entry {
+			bool			alive = true;
+			UInt32			epoch = 0;		// epoch in which the alive bit was last known to be right
+			API_ElemTypeID	type = API_ZombieElemID;
+		};
+
+		GS::HashTable<API_Guid, Entry>	g_entries;
+		GS::HashTable<API_Guid, UInt32>	g_observers;		// element -> number of users of its observer
+		UInt32							g_epoch = 1;
+		bool							g_restoring = false;
+
+		// Hotspot changes carry the new position, so the feed can be served off the main thread
+		void RecordChange (ChangeFeed::ChangeKind kind, const API_Guid& guid, API_ElemTypeID type)
+		{
+			API_Coord position = {};
+			const bool hasPosition = kind != ChangeFeed::ChangeKind::Deleted && type == API_HotspotID &&
+									 SpatialIndex::GetHotspotPosition (guid, position);
+			ChangeFeed::Record (kind, guid, type, hasPosition ? &position : nullptr);
+		}
+
+		void SetAlive (const API_Guid& guid, bool alive, ChangeFeed::ChangeKind change)
+		{
+			Entry* entry = g_entries.GetPtr (guid);
+			if (entry == nullptr)
+				return;
+			entry->alive = alive;
+			entry->epoch = g_epoch;
+			RecordChange (change, guid, entry->type);
+		}
+
+		bool ReadAliveFromDatabase (const API_Guid& guid, API_ElemTypeID expectedType)
+		{
+			API_Elem_Head header = {};
+			header.guid = guid;
+			return ACAPI_Element_GetHeader (&header) == NoError && header.type == expectedType;
+		}
+
+		GSErrCode ElementEventHandler (const API_NotifyElementType* elemType)
+		{
+			if (elemType == nullptr)
+				return NoError;
+
+			SpatialIndex::OnElementEvent (*elemType);
+			DimensionHelper::OnElementEvent (*elemType);
+			HotspotSweeper::OnElementEvent (*elemType);
+			TrackingStore::OnElementEvent (*elemType);
+
+			switch (elemType->notifID) {
+				// Element disappeared from the database
+				case APINotifyElement_Delete:
+				case APINotifyElement_Undo_Created:
+				case APINotifyElement_Redo_Deleted:
+					SetAlive (elemType->elemHead.guid, false, ChangeFeed::ChangeKind::Deleted);
+					break;
+
+				// Element is back in the database
+				case APINotifyElement_Undo_Deleted:
+				case APINotifyElement_Redo_Created:
+					SetAlive (elemType->elemHead.guid, true, ChangeFeed::ChangeKind::Added);
+					break;
+
+				// Element is in the database, possibly changed
+				case APINotifyElement_New:
+				case APINotifyElement_Change:
+				case APINotifyElement_Edit:
+				case APINotifyElement_Undo_Modified:
+				case APINotifyElement_Redo_Modified:
+					SetAlive (elemType->elemHead.guid, true, ChangeFeed::ChangeKind::Modified);
+					break;
+
+				default:
+					break;
+			}
+
+			return NoError;
+		}
+	}
+
+	GSErrCode Initialize ()
+	{
+		GSErrCode err = ACAPI_Element_InstallElementObserver (ElementEventHandler);
+		if (err != NoError)
+			return err;
+
+		// New elements of any type (keeps the spatial index current)
+		return ACAPI_Element_CatchNewElement (nullptr, ElementEventHandler);
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close:
+			case APINotify_ReceiveChanges:
+				// Notifications for tracked elements may have been missed - revalidate lazily
+				++g_epoch;
+				// Observers belong to the elements of the previous project
+				if (notifID != APINotify_ReceiveChanges)
+					g_observers.Clear ();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	void Track (const API_Guid& guid, API_ElemTypeID type)
+	{
+		if (guid == APINULLGuid)
+			return;
+
+		Entry entry;
+		entry.alive = true;
+		entry.epoch = g_restoring ? 0 : g_epoch;
+		entry.type = type;
+		if (!g_restoring)
+			RecordChange (ChangeFeed::ChangeKind::Added, guid, type);
+		if (g_entries.ContainsKey (guid)) {
+			g_entries[guid] = entry;
+		} else {
+			g_entries.Add (guid, entry);
+			Observe (guid);
+		}
+	}
+
+	void Untrack (const API_Guid& guid)
+	{
+		const Entry* entry = g_entries.GetPtr (guid);
+		if (entry == nullptr)
+			return;
+
+		// Leaving the tracked set looks like a deletion to clients (unless already reported
+		// or the maps are only being dropped for a reload)
+		if (entry->alive && !g_restoring)
+			ChangeFeed::Record (ChangeFeed::ChangeKind::Deleted, guid, entry->type);
+		g_entries.Delete (guid);
+		Unobserve (guid);
+	}
+
+	void Clear ()
+	{
+		for (auto it = g_entries.Begin (); it != g_entries.End (); ++it)
+			Unobserve (it->key);
+		g_entries.Clear ();
+	}
+
+	void SetRestoring (bool restoring)
+	{
+		g_restoring = restoring;
+	}
+
+	bool IsAlive (const API_Guid& guid, API_ElemTypeID expectedType)
+	{
+		if (guid == APINULLGuid)
+			return false;
+
+		Entry* entry = g_entries.GetPtr (guid);
+		if (entry == nullptr)
+			return ReadAliveFromDatabase (guid, expectedType);
+
+		if (entry->epoch != g_epoch) {
+			entry->alive = ReadAliveFromDatabase (guid, expectedType);
+			entry->epoch = g_epoch;
+		}
+		return entry->alive;
+	}
+
+	void Observe (const API_Guid& guid)
+	{
+		UInt32* count = g_observers.GetPtr (guid);
+		if (count != nullptr) {
+			++*count;
+			return;
+		}
+		g_observers.Add (guid, 1);
+		ACAPI_Element_AttachObserver (guid);
+	}
+
+	void Unobserve (const API_Guid& guid)
+	{
+		UInt32* count = g_observers.GetPtr (guid);
+		if (count == nullptr)
+			return;
+		if (--*count == 0) {
+			g_observers.Delete (guid);
+			ACAPI_Element_DetachObserver (guid);
+		}
+	}
+
+} // namespace ElementTracker
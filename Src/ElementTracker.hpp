@@ -0,0 +1,52 @@
+// *****************************************************************************
+// Header file for ElementTracker module (notification-driven validity cache)
+// *****************************************************************************
+
+#ifndef ELEMENTTRACKER_HPP
+#define ELEMENTTRACKER_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// Keeps an "element is alive" bit for every element tracked by HotspotManager
+// and DimensionManager. The bit is maintained from element notifications
+// (delete, undo, redo), so hot-path lookups never touch the database.
+//
+// Project events after which notifications may have been missed (open, new,
+// teamwork receive, ...) start a new epoch: entries validated in an earlier
+// epoch are re-checked with one ACAPI_Element_GetHeader on next access.
+//
+// Every add / change / delete of a tracked element is recorded in ChangeFeed.
+// -----------------------------------------------------------------------------
+
+namespace ElementTracker {
+
+	// Install the element observer - call once from Initialize
+	// The observer is shared: element events are also forwarded to SpatialIndex, DimensionHelper and HotspotSweeper
+	GSErrCode	Initialize ();
+
+	// Forward project events (APINotify_*) - called from the add-on's project event handler
+	void		OnProjectEvent (API_NotifyEventID notifID);
+
+	// Start / stop observing an element
+	void		Track (const API_Guid& guid, API_ElemTypeID type);
+	void		Untrack (const API_Guid& guid);
+	void		Clear ();
+
+	// While restoring, Track neither records to ChangeFeed nor trusts the element
+	// (restored entries are checked against the database on first access), and
+	// Untrack does not record the element as deleted
+	void		SetRestoring (bool restoring);
+
+	// In-memory existence check; falls back to the database only for stale entries
+	bool		IsAlive (const API_Guid& guid, API_ElemTypeID expectedType);
+
+	// Element observers shared by the tracker, SpatialIndex and the DimensionHelper
+	// hotspot cache: attached on the first Observe, detached with the last Unobserve
+	void		Observe (const API_Guid& guid);
+	void		Unobserve (const API_Guid& guid);
+
+} // namespace ElementTracker
+
+#endif // ELEMENTTRACKER_HPP
@@ -0,0 +1,172 @@
+// *****************************************************************************
+// Source code for EventLoop module (deferred work on the main thread)
+// *****************************************************************************
+
+#include "EventLoop.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace EventLoop {
+
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		// 'MDID' 32500 in RFIX/Dimension_GhFix.grc
+		constexpr UInt32	OwnDeveloperId = 909404777;
+		constexpr UInt32	OwnLocalId = 1753895032;
+
+		constexpr GSType	TickCommandId = 'DGTK';
+		constexpr Int32		TickCommandVersion = 1;
+
+		struct DelayedTask {
+			Task				task;
+			Clock::time_point	due;
+		};
+
+		// Shared with the timer thread
+		std::mutex					g_mutex;
+		std::condition_variable		g_timerChanged;
+		std::vector<Task>			g_scheduled;			// run by the next event loop call
+		std::vector<DelayedTask>	g_delayed;				// waiting on the timer thread
+		bool						g_callPending = false;	// a CallFromEventLoop is on its way
+		bool						g_stopping = false;
+		std::thread					g_timer;
+
+		void AddUnique (std::vector<Task>& tasks, Task task)
+		{
+			for (Task scheduled : tasks) {
+				if (scheduled == task) {
+					return;
+				}
+			}
+			tasks.push_back (task);
+		}
+
+		// Caller holds g_mutex
+		void PostCall ()
+		{
+			if (g_callPending) {
+				return;
+			}
+			API_ModulID mdid = {};
+			mdid.developerID = OwnDeveloperId;
+			mdid.localID = OwnLocalId;
+			g_callPending = (ACAPI_AddOnAddOnCommunication_CallFromEventLoop (&mdid, TickCommandId, TickCommandVersion, nullptr, true, nullptr) == NoError);
+		}
+
+		void TimerLoop ()
+		{
+			std::unique_lock<std::mutex> lock (g_mutex);
+			while (!g_stopping) {
+				if (g_delayed.empty ()) {
+					g_timerChanged.wait (lock);
+					continue;
+				}
+
+				Clock::time_point earliest = g_delayed[0].due;
+				for (const DelayedTask& delayed : g_delayed) {
+					earliest = std::min (earliest, delayed.due);
+				}
+				if (Clock::now () < earliest) {
+					g_timerChanged.wait_until (lock, earliest);
+					continue;
+				}
+
+				const Clock::time_point now = Clock::now ();
+				for (size_t i = 0; i < g_delayed.size ();) {
+					if (g_delayed[i].due <= now) {
+						AddUnique (g_scheduled, g_delayed[i].task);
+						g_delayed.erase (g_delayed.begin () + i);
+					} else {
+						++i;
+					}
+				}
+				PostCall ();
+			}
+		}
+
+		GSErrCode __ACENV_CALL TickHandler (GSHandle /*params*/, GSPtr /*resultData*/, bool /*silentMode*/)
+		{
+			// Tasks scheduled while these run go to the next call
+			std::vector<Task> tasks;
+			{
+				std::lock_guard<std::mutex> lock (g_mutex);
+				g_callPending = false;
+				tasks.swap (g_scheduled);
+			}
+			for (Task task : tasks) {
+				task ();
+			}
+			return NoError;
+		}
+	}
+
+	GSErrCode RegisterInterface ()
+	{
+		return ACAPI_AddOnAddOnCommunication_RegisterSupportedService (TickCommandId, TickCommandVersion);
+	}
+
+	GSErrCode Initialize ()
+	{
+		return ACAPI_AddOnAddOnCommunication_InstallModulCommandHandler (TickCommandId, TickCommandVersion, TickHandler);
+	}
+
+	void Shutdown ()
+	{
+		{
+			std::lock_guard<std::mutex> lock (g_mutex);
+			g_stopping = true;
+			g_delayed.clear ();
+			g_scheduled.clear ();
+		}
+		g_timerChanged.notify_all ();
+		if (g_timer.joinable ()) {
+			g_timer.join ();
+		}
+	}
+
+	void Schedule (Task task)
+	{
+		std::lock_guard<std::mutex> lock (g_mutex);
+		if (g_stopping) {
+			return;
+		}
+		AddUnique (g_scheduled, task);
+		PostCall ();
+	}
+
+	void ScheduleAfter (Task task, UInt32 delayMs)
+	{
+		if (delayMs == 0) {
+			Schedule (task);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock (g_mutex);
+			if (g_stopping) {
+				return;
+			}
+			const Clock::time_point due = Clock::now () + std::chrono::milliseconds (delayMs);
+			bool found = false;
+			for (DelayedTask& delayed : g_delayed) {
+				if (delayed.task == task) {
+					delayed.due = std::min (delayed.due, due);
+					found = true;
+				}
+			}
+			if (!found) {
+				g_delayed.push_back ({ task, due });
+			}
+			if (!g_timer.joinable ()) {
+				g_timer = std::thread (TimerLoop);
+			}
+		}
+		g_timerChanged.notify_all ();
+	}
+
+} // namespace EventLoop
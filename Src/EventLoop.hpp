@@ -0,0 +1,46 @@
+// *****************************************************************************
+// Header file for EventLoop module (deferred work on the main thread)
+// *****************************************************************************
+
+#ifndef EVENTLOOP_HPP
+#define EVENTLOOP_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// Work the add-on wants to do later without waiting for the next request
+// (the next live-drag frame, the next chunk of a job). Schedule posts one
+// call of the add-on's own modul command through
+// ACAPI_AddOnAddOnCommunication_CallFromEventLoop; Archicad runs it on the
+// main thread once the requests already waiting have been processed, so the
+// database may be modified there as in any command.
+//
+// ScheduleAfter keeps the task on a timer thread that sleeps until the task is
+// due and only then posts the call - nothing polls while waiting. A task
+// scheduled again before it ran runs once; a task that still has work to do
+// schedules itself again.
+// -----------------------------------------------------------------------------
+
+namespace EventLoop {
+
+	using Task = void (*) ();
+
+	// Register the modul command - call once from RegisterInterface
+	GSErrCode	RegisterInterface ();
+
+	// Install the modul command handler - call once from Initialize
+	GSErrCode	Initialize ();
+
+	// Stop the timer thread - call once from FreeData
+	void		Shutdown ();
+
+	// Run task from the event loop soon
+	void		Schedule (Task task);
+
+	// Run task from the event loop in delayMs at the earliest
+	void		ScheduleAfter (Task task, UInt32 delayMs);
+
+} // namespace EventLoop
+
+#endif // EVENTLOOP_HPP
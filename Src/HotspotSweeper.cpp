@@ -0,0 +1,328 @@
+// *****************************************************************************
+// Source code for HotspotSweeper module (garbage collection of orphan hotspots)
+// *****************************************************************************
+
+#include "HotspotSweeper.hpp"
+#include "DimensionCommands.hpp"
+#include "DimensionSets.hpp"
+#include "ElementTracker.hpp"
+#include "EventLoop.hpp"
+#include "UndoSession.hpp"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+namespace HotspotSweeper {
+
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		constexpr UInt32 SessionRetryMs = 1000;		// a sweep waits while a session is recording
+
+		struct Candidate {
+			API_Guid			guid = APINULLGuid;
+			Clock::time_point	since;
+		};
+
+		// FIFO by mark time; re-marking pushes a new entry and leaves the old one stale
+		std::deque<Candidate>						g_queue;
+		GS::HashTable<API_Guid, Clock::time_point>	g_markedAt;
+
+		// Hotspot nodes of the untracked dimensions (observed, so changes and deletions arrive)
+		// Built by one pass over the dimensions of the project, then kept from notifications
+		bool											g_dimensionIndexBuilt = false;
+		GS::HashTable<API_Guid, GS::Array<API_Guid>>	g_untrackedDimensions;		// dimension -> hotspots it uses
+		GS::HashTable<API_Guid, UInt32>					g_untrackedReferences;		// hotspot -> untracked dimensions using it
+		GS::HashSet<API_Guid>							g_changedDimensions;		// re-read before the next sweep
+
+		bool IsReferenced (const API_Guid& hotspotGuid)
+		{
+			return DimensionSets::ContainsHotspot (hotspotGuid) || DimensionManager::GetReferenceCount (hotspotGuid) > 0;
+		}
+
+		GS::Array<API_Guid> ReadHotspotNodes (const API_Guid& dimensionGuid, bool& exists)
+		{
+			GS::Array<API_Guid> hotspots;
+			API_ElementMemo memo = {};
+			exists = (ACAPI_Element_GetMemo (dimensionGuid, &memo) == NoError);
+			if (!exists) {
+				return hotspots;
+			}
+			const Int32 nodeCount = (memo.dimElems != nullptr) ? (Int32)(BMGetHandleSize ((GSHandle)memo.dimElems) / sizeof (API_DimElem)) : 0;
+			for (Int32 i = 0; i < nodeCount; ++i) {
+				const API_DimElem& dimElem = (*memo.dimElems)[i];
+				if (dimElem.base.base.type == API_HotspotID && !hotspots.Contains (dimElem.base.base.guid)) {
+					hotspots.Push (dimElem.base.base.guid);
+				}
+			}
+			ACAPI_DisposeElemMemoHdls (&memo);
+			return hotspots;
+		}
+
+		void AddUntrackedReferences (const GS::Array<API_Guid>& hotspots)
+		{
+			for (const API_Guid& hotspotGuid : hotspots) {
+				UInt32* count = g_untrackedReferences.GetPtr (hotspotGuid);
+				if (count != nullptr) {
+					++*count;
+				} else {
+					g_untrackedReferences.Add (hotspotGuid, 1);
+				}
+			}
+		}
+
+		// A hotspot left by its last untracked dimension may be garbage now
+		void RemoveUntrackedReferences (const GS::Array<API_Guid>& hotspots)
+		{
+			for (const API_Guid& hotspotGuid : hotspots) {
+				UInt32* count = g_untrackedReferences.GetPtr (hotspotGuid);
+				if (count != nullptr && --*count == 0) {
+					g_untrackedReferences.Delete (hotspotGuid);
+					MarkCandidate (hotspotGuid);
+				}
+			}
+		}
+
+		// Re-read one dimension; tracked and deleted dimensions leave the index
+		void UpdateUntrackedDimension (const API_Guid& dimensionGuid)
+		{
+			GS::Array<API_Guid>* indexed = g_untrackedDimensions.GetPtr (dimensionGuid);
+			bool exists = false;
+			GS::Array<API_Guid> hotspots;
+			if (!DimensionManager::IsTrackedDimension (dimensionGuid)) {
+				hotspots = ReadHotspotNodes (dimensionGuid, exists);
+			}
+
+			if (indexed != nullptr) {
+				const GS::Array<API_Guid> previous = *indexed;
+				if (exists) {
+					*indexed = hotspots;
+				} else {
+					g_untrackedDimensions.Delete (dimensionGuid);
+					ElementTracker::Unobserve (dimensionGuid);
+				}
+				AddUntrackedReferences (hotspots);
+				RemoveUntrackedReferences (previous);
+			} else if (exists) {
+				g_untrackedDimensions.Add (dimensionGuid, hotspots);
+				ElementTracker::Observe (dimensionGuid);
+				AddUntrackedReferences (hotspots);
+			}
+		}
+
+		void ClearDimensionIndex ()
+		{
+			for (auto it = g_untrackedDimensions.Begin (); it != g_untrackedDimensions.End (); ++it) {
+				ElementTracker::Unobserve (it->key);
+			}
+			g_untrackedDimensions.Clear ();
+			g_untrackedReferences.Clear ();
+			g_changedDimensions.Clear ();
+			g_dimensionIndexBuilt = false;
+		}
+
+		// One pass over the project's dimensions the first time there is garbage; afterwards only
+		// the dimensions notifications reported since the last sweep are re-read
+		void UpdateDimensionIndex ()
+		{
+			if (!g_dimensionIndexBuilt) {
+				GS::Array<API_Guid> dimensions;
+				ACAPI_Element_GetElemList (API_DimensionID, &dimensions);
+				for (const API_Guid& dimensionGuid : dimensions) {
+					UpdateUntrackedDimension (dimensionGuid);
+				}
+				g_changedDimensions.Clear ();
+				g_dimensionIndexBuilt = true;
+				return;
+			}
+
+			for (const API_Guid& dimensionGuid : g_changedDimensions) {
+				UpdateUntrackedDimension (dimensionGuid);
+			}
+			g_changedDimensions.Clear ();
+		}
+
+		// Dimensions the user drew onto our hotspots are not tracked, yet deleting the hotspot would break them
+		void KeepHotspotsOfUntrackedDimensions (GS::Array<API_Guid>& garbage)
+		{
+			UpdateDimensionIndex ();
+			if (g_untrackedReferences.IsEmpty ()) {
+				return;
+			}
+			GS::Array<API_Guid> kept;
+			for (const API_Guid& hotspotGuid : garbage) {
+				if (!g_untrackedReferences.ContainsKey (hotspotGuid)) {
+					kept.Push (hotspotGuid);
+				}
+			}
+			garbage = kept;
+		}
+
+		// Drop stale entries from the front; true if the oldest candidate is past its grace period
+		bool HasDueCandidate ()
+		{
+			while (!g_queue.empty ()) {
+				const Candidate& candidate = g_queue.front ();
+				const Clock::time_point* markedAt = g_markedAt.GetPtr (candidate.guid);
+				if (markedAt != nullptr && *markedAt == candidate.since) {
+					return Clock::now () - candidate.since >= std::chrono::milliseconds (GracePeriodMs);
+				}
+				g_queue.pop_front ();
+			}
+			return false;
+		}
+
+		// Pop due candidates that are unreferenced; stops at the first one still in its grace period
+		GS::Array<API_Guid> CollectGarbage (UInt32 maxCount)
+		{
+			GS::Array<API_Guid> garbage;
+			const Clock::time_point now = Clock::now ();
+			const Clock::duration grace = std::chrono::milliseconds (GracePeriodMs);
+
+			UInt32 examined = 0;
+			while (!g_queue.empty () && examined < maxCount) {
+				const Candidate candidate = g_queue.front ();
+				const Clock::time_point* markedAt = g_markedAt.GetPtr (candidate.guid);
+				if (markedAt == nullptr || *markedAt != candidate.since) {
+					g_queue.pop_front ();		// stale entry, a newer one is queued
+					continue;
+				}
+				if (now - candidate.since < grace) {
+					break;
+				}
+
+				g_queue.pop_front ();
+				g_markedAt.Delete (candidate.guid);
+				++examined;
+
+				if (!HotspotManager::IsTrackedHotspot (candidate.guid) || !ElementTracker::IsAlive (candidate.guid, API_HotspotID)) {
+					continue;
+				}
+				if (!IsReferenced (candidate.guid)) {
+					garbage.Push (candidate.guid);
+				}
+			}
+			if (!garbage.IsEmpty ()) {
+				KeepHotspotsOfUntrackedDimensions (garbage);
+			}
+			return garbage;
+		}
+
+		UInt32 SweepInUndoScope (UInt32 maxCount)
+		{
+			const GS::Array<API_Guid> garbage = CollectGarbage (maxCount);
+			if (garbage.IsEmpty () || ACAPI_Element_Delete (garbage) != NoError) {
+				return 0;
+			}
+			for (const API_Guid& hotspotGuid : garbage) {
+				HotspotManager::RemoveHotspot (hotspotGuid);
+			}
+			return garbage.GetSize ();
+		}
+
+		// Idle-time sweeper: one chunk per event loop call while candidates are due,
+		// then sleeps until the oldest candidate leaves its grace period
+		void SweepTick ()
+		{
+			if (UndoSession::IsRecording ()) {
+				EventLoop::ScheduleAfter (SweepTick, SessionRetryMs);
+				return;
+			}
+			Sweep ();
+			if (HasDueCandidate ()) {
+				EventLoop::Schedule (SweepTick);
+			} else if (!g_queue.empty ()) {
+				const Clock::duration waited = Clock::now () - g_queue.front ().since;
+				const UInt32 waitedMs = (UInt32)std::chrono::duration_cast<std::chrono::milliseconds> (waited).count ();
+				EventLoop::ScheduleAfter (SweepTick, GracePeriodMs - std::min (waitedMs, GracePeriodMs) + 1);
+			}
+		}
+	}
+
+	void MarkCandidate (const API_Guid& hotspotGuid)
+	{
+		if (hotspotGuid == APINULLGuid) {
+			return;
+		}
+
+		Candidate candidate;
+		candidate.guid = hotspotGuid;
+		candidate.since = Clock::now ();
+		if (g_markedAt.ContainsKey (hotspotGuid)) {
+			g_markedAt[hotspotGuid] = candidate.since;
+		} else {
+			g_markedAt.Add (hotspotGuid, candidate.since);
+		}
+		g_queue.push_back (candidate);
+		EventLoop::ScheduleAfter (SweepTick, GracePeriodMs);
+	}
+
+	void OnElementEvent (const API_NotifyElementType& elemEvent)
+	{
+		if (elemEvent.elemHead.type != API_DimensionID) {
+			return;
+		}
+		// Untracked dimensions are re-read before the next sweep - not in the notification itself
+		if (g_dimensionIndexBuilt) {
+			g_changedDimensions.Add (elemEvent.elemHead.guid);
+		}
+
+		switch (elemEvent.notifID) {
+			case APINotifyElement_Delete:
+			case APINotifyElement_Undo_Created:
+			case APINotifyElement_Redo_Deleted:
+				// Tracking is kept (undo may bring the dimension back); only the references are gone
+				for (const API_Guid& hotspotGuid : DimensionManager::GetHotspotsForDimension (elemEvent.elemHead.guid)) {
+					MarkCandidate (hotspotGuid);
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close:
+			case APINotify_Quit:
+				g_queue.clear ();
+				g_markedAt.Clear ();
+				ClearDimensionIndex ();
+				break;
+
+			case APINotify_ReceiveChanges:
+				// Teamwork changes of dimensions may have been missed - rebuild on the next sweep
+				ClearDimensionIndex ();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	UInt32 Sweep (UInt32 maxCount)
+	{
+		// Nothing due: no (empty) undo step
+		if (!HasDueCandidate ()) {
+			return 0;
+		}
+
+		UInt32 deletedCount = 0;
+		UndoSession::RunUndoable ("SweepHotspots", [&]() -> GSErrCode {
+			deletedCount = SweepInUndoScope (maxCount);
+			return NoError;
+		});
+		return deletedCount;
+	}
+
+	UInt32 GetPendingCount ()
+	{
+		return g_markedAt.GetSize ();
+	}
+
+} // namespace HotspotSweeper
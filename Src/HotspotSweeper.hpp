@@ -0,0 +1,56 @@
+// *****************************************************************************
+// Header file for HotspotSweeper module (garbage collection of orphan hotspots)
+// *****************************************************************************
+
+#ifndef HOTSPOTSWEEPER_HPP
+#define HOTSPOTSWEEPER_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// A tracked hotspot is referenced by every live dimension attached to it
+// (DimensionManager::GetReferenceCount) and by every named set containing it
+// (DimensionSets). A hotspot that loses its last dimension or set becomes a
+// candidate; a candidate that is still unreferenced after a grace period is
+// deleted. Hotspots that never had a reference (CreateHotspot without a
+// dimension) are the client's and are never collected. Dimensions the user
+// drew onto a hotspot are not tracked, so before deleting, the untracked
+// dimensions are checked too; a hotspot one of them uses is left alone. Their
+// hotspot nodes are indexed once per project and then kept up to date from
+// dimension notifications.
+//
+// Sweeping runs at idle time from the event loop, in its own undo step, so
+// undoing a batch never brings back hotspots collected meanwhile. Each call
+// deletes at most one chunk, so there is no big blocking cleanup; clients may
+// also send SweepHotspots.
+// -----------------------------------------------------------------------------
+
+namespace HotspotSweeper {
+
+	// Hotspots examined per sweep call
+	constexpr UInt32	DefaultChunkSize = 64;
+
+	// How long a hotspot may stay unreferenced before it is collected
+	// (covers CreateHotspot followed by CreateLinearDimension)
+	constexpr UInt32	GracePeriodMs = 30000;
+
+	// The hotspot may have lost its last reference - schedules the idle-time sweep
+	void		MarkCandidate (const API_Guid& hotspotGuid);
+
+	// Forward element notifications - a deleted dimension releases its hotspots,
+	// a changed untracked dimension is re-indexed
+	void		OnElementEvent (const API_NotifyElementType& elemEvent);
+
+	// Forward project events (APINotify_*) - candidates never outlive their project
+	void		OnProjectEvent (API_NotifyEventID notifID);
+
+	// Examine up to maxCount due candidates and delete the unreferenced ones in one undo step
+	UInt32		Sweep (UInt32 maxCount = DefaultChunkSize);
+
+	// Candidates not examined yet (including those still in their grace period)
+	UInt32		GetPendingCount ();
+
+} // namespace HotspotSweeper
+
+#endif // HOTSPOTSWEEPER_HPP
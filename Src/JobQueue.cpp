@@ -0,0 +1,259 @@
+// *****************************************************************************
+// Source code for JobQueue module (chunked background execution of batches)
+// *****************************************************************************
+
+#include "JobQueue.hpp"
+#include "DimensionCommands.hpp"
+#include "EventLoop.hpp"
+#include "UndoSession.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace JobQueue {
+
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		// Finished jobs are kept for status queries, the oldest ones are dropped
+		constexpr UInt32 MaxFinishedJobs = 64;
+
+		struct Job {
+			Int32						id = 0;
+			GS::UniString				commandName;
+			const API_AddOnCommand*		command = nullptr;
+			const char*					itemsKey = nullptr;
+			GS::Array<GS::ObjectState>	items;
+			GS::ObjectState				parameters;
+			UInt32						chunkSize = DefaultChunkSize;
+			UInt32						totalCount = 0;
+			UInt32						doneCount = 0;
+			JobState					state = JobState::Queued;
+			GS::Array<GS::ObjectState>	chunkResults;
+			GS::UniString				error;
+		};
+
+		struct JobCommand {
+			const char*					name;
+			const char*					itemsKey;
+			const API_AddOnCommand&		command;
+		};
+
+		// Stateless - private instances, the registered ones are owned by Archicad
+		CreateLinearDimensionsCommand	g_createLinearDimensions;
+		UpsertHotspotsCommand			g_upsertHotspots;
+
+		const JobCommand g_jobCommands[] = {
+			{ "CreateLinearDimensions",	"pairs",	g_createLinearDimensions },
+			{ "UpsertHotspots",			"points",	g_upsertHotspots },
+		};
+
+		// Ticks from the event loop have no request, so nothing can break them (Escape included) - CancelJob still can
+		GS::NullProcessControl		g_tickProcessControl;
+
+		GS::HashTable<Int32, Job>	g_jobs;
+		GS::Array<Int32>			g_active;		// FIFO of queued / running jobs
+		GS::Array<Int32>			g_finished;		// oldest first
+		Int32						g_nextJobId = 1;
+
+		const JobCommand* FindJobCommand (const GS::UniString& commandName)
+		{
+			for (const JobCommand& jobCommand : g_jobCommands) {
+				if (commandName == jobCommand.name) {
+					return &jobCommand;
+				}
+			}
+			return nullptr;
+		}
+
+		const char* StateToString (JobState state)
+		{
+			switch (state) {
+				case JobState::Queued:		return "queued";
+				case JobState::Running:		return "running";
+				case JobState::Done:		return "done";
+				case JobState::Cancelled:	return "cancelled";
+				case JobState::Failed:		return "failed";
+			}
+			return "failed";
+		}
+
+		void Finish (Job& job, JobState state)
+		{
+			job.state = state;
+			job.items.Clear ();		// the inputs are not needed any more
+			for (UIndex i = 0; i < g_active.GetSize (); ++i) {
+				if (g_active[i] == job.id) {
+					g_active.Delete (i);
+					break;
+				}
+			}
+			g_finished.Push (job.id);
+			while (g_finished.GetSize () > MaxFinishedJobs) {
+				g_jobs.Delete (g_finished[0]);
+				g_finished.Delete (0);
+			}
+		}
+
+		// One call of the batch command on the next items slice
+		void RunChunk (Job& job, GS::ProcessControl& processControl)
+		{
+			const UInt32 first = job.doneCount;
+			const UInt32 last = std::min (first + job.chunkSize, job.items.GetSize ());
+
+			GS::Array<GS::ObjectState> slice;
+			slice.SetCapacity (last - first);
+			for (UInt32 i = first; i < last; ++i) {
+				slice.Push (job.items[i]);
+			}
+
+			GS::ObjectState chunkParameters = job.parameters;
+			chunkParameters.Add (job.itemsKey, slice);
+
+			job.state = JobState::Running;
+			const GS::ObjectState response = job.command->Execute (chunkParameters, processControl);
+			job.chunkResults.Push (response);
+
+			bool success = false;
+			if (!response.Get ("success", success) || !success) {
+				job.error = "Chunk failed - see the last entry of chunkResults";
+				Finish (job, JobState::Failed);
+				return;
+			}
+
+			job.doneCount = last;
+			if (job.doneCount >= job.items.GetSize ()) {
+				Finish (job, JobState::Done);
+			}
+		}
+
+		// Runs from the event loop until no job is active
+		void Tick ()
+		{
+			if (UndoSession::IsRecording ()) {
+				// Chunks would only be queued into the session; retry once it is committed
+				EventLoop::ScheduleAfter (Tick, DefaultTickBudgetMs);
+				return;
+			}
+			RunTick (DefaultTickBudgetMs, g_tickProcessControl);
+			if (!g_active.IsEmpty ()) {
+				EventLoop::Schedule (Tick);
+			}
+		}
+	}
+
+	bool GetItemsKey (const GS::UniString& commandName, const char*& itemsKey)
+	{
+		const JobCommand* jobCommand = FindJobCommand (commandName);
+		if (jobCommand == nullptr) {
+			return false;
+		}
+		itemsKey = jobCommand->itemsKey;
+		return true;
+	}
+
+	Int32 Submit (const GS::UniString& commandName, const GS::Array<GS::ObjectState>& items,
+				  const GS::ObjectState& parameters, UInt32 chunkSize)
+	{
+		const JobCommand* jobCommand = FindJobCommand (commandName);
+		if (jobCommand == nullptr) {
+			return 0;
+		}
+
+		Job job;
+		job.id = g_nextJobId++;
+		job.commandName = commandName;
+		job.command = &jobCommand->command;
+		job.itemsKey = jobCommand->itemsKey;
+		job.items = items;
+		job.totalCount = items.GetSize ();
+		job.parameters = parameters;
+		job.chunkSize = std::min (std::max (chunkSize, (UInt32)1), MaxChunkSize);
+
+		const Int32 jobId = job.id;
+		g_jobs.Add (jobId, job);
+		if (items.IsEmpty ()) {
+			Finish (g_jobs[jobId], JobState::Done);
+		} else {
+			g_active.Push (jobId);
+			EventLoop::Schedule (Tick);
+		}
+		return jobId;
+	}
+
+	bool RunTick (UInt32 budgetMs, GS::ProcessControl& processControl)
+	{
+		if (UndoSession::IsRecording ()) {
+			return true;
+		}
+
+		const Clock::time_point deadline = Clock::now () + std::chrono::milliseconds (budgetMs);
+		do {
+			if (g_active.IsEmpty ()) {
+				return true;
+			}
+			if (processControl.IsBreaked ()) {
+				return false;
+			}
+			RunChunk (g_jobs[g_active[0]], processControl);
+		} while (Clock::now () < deadline);
+		return true;
+	}
+
+	bool GetStatus (Int32 jobId, UInt32 fromChunk, GS::ObjectState& status)
+	{
+		const Job* job = g_jobs.GetPtr (jobId);
+		if (job == nullptr) {
+			return false;
+		}
+
+		GS::Array<GS::ObjectState> chunkResults;
+		for (UInt32 i = fromChunk; i < job->chunkResults.GetSize (); ++i) {
+			chunkResults.Push (job->chunkResults[i]);
+		}
+
+		status.Add ("jobId", job->id);
+		status.Add ("command", job->commandName);
+		status.Add ("state", StateToString (job->state));
+		status.Add ("doneCount", (Int32)job->doneCount);
+		status.Add ("totalCount", (Int32)job->totalCount);
+		status.Add ("chunkCount", (Int32)job->chunkResults.GetSize ());
+		status.Add ("chunkResults", chunkResults);
+		if (!job->error.IsEmpty ()) {
+			status.Add ("error", job->error);
+		}
+		return true;
+	}
+
+	bool Cancel (Int32 jobId, const GS::UniString& reason)
+	{
+		Job* job = g_jobs.GetPtr (jobId);
+		if (job == nullptr || (job->state != JobState::Queued && job->state != JobState::Running)) {
+			return false;
+		}
+		job->error = reason;
+		Finish (*job, JobState::Cancelled);
+		return true;
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close:
+			case APINotify_Quit:
+				// Items refer to the previous project
+				while (!g_active.IsEmpty ()) {
+					Job& job = g_jobs[g_active[0]];
+					job.error = "Project was closed";
+					Finish (job, JobState::Cancelled);
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+
+} // namespace JobQueue
@@ -0,0 +1,67 @@
+// *****************************************************************************
+// Header file for JobQueue module (chunked background execution of batches)
+// *****************************************************************************
+
+#ifndef JOBQUEUE_HPP
+#define JOBQUEUE_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// A job is a batch command (CreateLinearDimensions, UpsertHotspots) whose
+// items array is cut into chunks. SubmitJob only stores the job and answers
+// with its ID; each chunk later runs as a normal call of the batch command,
+// so it has its own undo step and its response is kept as a partial result.
+//
+// Jobs advance on their own: while a job is active, a tick is scheduled from
+// the Archicad event loop (EventLoop) that runs chunks of the oldest active job
+// for DefaultTickBudgetMs and schedules the next tick, so Archicad handles
+// user input and other requests between two ticks. GetJobStatus only reports
+// (or runs chunks at once when asked to); a break in its ProcessControl
+// (Escape in Archicad) cancels the job it asked about, like CancelJob does.
+// Event loop ticks run with a NullProcessControl: they belong to no request,
+// so Escape does not stop a job that advances on its own - only CancelJob (or
+// a GetJobStatus call broken by Escape) does. Chunks that already ran stay in
+// the project.
+// -----------------------------------------------------------------------------
+
+namespace JobQueue {
+
+	constexpr UInt32	DefaultChunkSize = 200;
+	constexpr UInt32	MaxChunkSize = 5000;
+	constexpr UInt32	DefaultTickBudgetMs = 100;
+
+	enum class JobState {
+		Queued,
+		Running,
+		Done,
+		Cancelled,
+		Failed
+	};
+
+	// True if the command can run as a job; itemsKey is the name of its items array
+	bool		GetItemsKey (const GS::UniString& commandName, const char*& itemsKey);
+
+	// Store a job and return its ID; parameters go to every chunk next to the items slice
+	Int32		Submit (const GS::UniString& commandName, const GS::Array<GS::ObjectState>& items,
+						const GS::ObjectState& parameters, UInt32 chunkSize);
+
+	// Run chunks of the oldest active job for up to budgetMs (at least one chunk)
+	// Returns false if a break in processControl stopped it; cancelling is up to the caller
+	bool		RunTick (UInt32 budgetMs, GS::ProcessControl& processControl);
+
+	// { jobId, command, state, doneCount, totalCount, chunkCount, chunkResults: [ chunk responses from fromChunk on ], error }
+	// Returns false if the job is unknown
+	bool		GetStatus (Int32 jobId, UInt32 fromChunk, GS::ObjectState& status);
+
+	// Stop a queued or running job; reason goes to its error
+	// Returns false if the job is unknown or already finished
+	bool		Cancel (Int32 jobId, const GS::UniString& reason);
+
+	// Forward project events (APINotify_*) - jobs never outlive their project
+	void		OnProjectEvent (API_NotifyEventID notifID);
+
+} // namespace JobQueue
+
+#endif // JOBQUEUE_HPP
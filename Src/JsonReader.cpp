@@ -0,0 +1,464 @@
+// *****************************************************************************
+// Source code for JsonReader module (single-pass JSON tokenizer / DOM)
+// *****************************************************************************
+
+#include "JsonReader.hpp"
+#include "NumberParser.hpp"
+
+namespace JsonReader {
+
+	namespace {
+		inline bool IsWhitespace (char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+		}
+
+		inline bool IsDigit (char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		inline int HexValue (char c)
+		{
+			if (c >= '0' && c <= '9') return c - '0';
+			if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+			if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+			return -1;
+		}
+
+		bool ReadHex4 (std::string_view raw, std::size_t pos, std::uint32_t& out)
+		{
+			if (pos + 4 > raw.size ())
+				return false;
+			out = 0;
+			for (std::size_t i = 0; i < 4; ++i) {
+				int h = HexValue (raw[pos + i]);
+				if (h < 0)
+					return false;
+				out = (out << 4) | (std::uint32_t)h;
+			}
+			return true;
+		}
+
+		void AppendUtf8 (std::uint32_t cp, std::string& out)
+		{
+			if (cp < 0x80) {
+				out += (char)cp;
+			} else if (cp < 0x800) {
+				out += (char)(0xC0 | (cp >> 6));
+				out += (char)(0x80 | (cp & 0x3F));
+			} else if (cp < 0x10000) {
+				out += (char)(0xE0 | (cp >> 12));
+				out += (char)(0x80 | ((cp >> 6) & 0x3F));
+				out += (char)(0x80 | (cp & 0x3F));
+			} else {
+				out += (char)(0xF0 | (cp >> 18));
+				out += (char)(0x80 | ((cp >> 12) & 0x3F));
+				out += (char)(0x80 | ((cp >> 6) & 0x3F));
+				out += (char)(0x80 | (cp & 0x3F));
+			}
+		}
+
+		// Parser states while inside a container
+		enum class State {
+			ValueOrClose,	// just after '['
+			KeyOrClose,		// just after '{'
+			Key,			// after ',' in an object
+			Value,			// after ':' or ',' in an array
+			CommaOrClose	// after a complete member/element
+		};
+	}
+
+	// -------------------------------------------------------------------------
+	// String unescaping
+	// -------------------------------------------------------------------------
+
+	bool UnescapeString (std::string_view raw, std::string& out)
+	{
+		out.clear ();
+		out.reserve (raw.size ());
+		for (std::size_t i = 0; i < raw.size (); ++i) {
+			char c = raw[i];
+			if (c != '\\') {
+				out += c;
+				continue;
+			}
+			if (++i >= raw.size ())
+				return false;
+			switch (raw[i]) {
+				case '"':	out += '"';		break;
+				case '\\':	out += '\\';	break;
+				case '/':	out += '/';		break;
+				case 'b':	out += '\b';	break;
+				case 'f':	out += '\f';	break;
+				case 'n':	out += '\n';	break;
+				case 'r':	out += '\r';	break;
+				case 't':	out += '\t';	break;
+				case 'u': {
+					std::uint32_t cp = 0;
+					if (!ReadHex4 (raw, i + 1, cp))
+						return false;
+					i += 4;
+					// Surrogate pair
+					if (cp >= 0xD800 && cp <= 0xDBFF) {
+						std::uint32_t low = 0;
+						if (i + 2 < raw.size () && raw[i + 1] == '\\' && raw[i + 2] == 'u' && ReadHex4 (raw, i + 3, low) && low >= 0xDC00 && low <= 0xDFFF) {
+							cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+							i += 6;
+						} else {
+							cp = 0xFFFD;
+						}
+					} else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+						cp = 0xFFFD;
+					}
+					AppendUtf8 (cp, out);
+					break;
+				}
+				default:
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// -------------------------------------------------------------------------
+	// Document
+	// -------------------------------------------------------------------------
+
+	bool Document::Fail (std::size_t offset, const char* message)
+	{
+		errorOffset = offset;
+		errorMessage = message;
+		nodes.clear ();
+		return false;
+	}
+
+	// pos points at the opening quote; on success it points one past the closing quote
+	bool Document::ScanString (std::size_t& pos, bool& escaped)
+	{
+		const std::size_t size = source.size ();
+		const char* data = source.data ();
+		escaped = false;
+		for (std::size_t i = pos + 1; i < size; ++i) {
+			char c = data[i];
+			if (c == '"') {
+				pos = i + 1;
+				return true;
+			}
+			if (c == '\\') {
+				escaped = true;
+				++i;
+			} else if ((unsigned char)c < 0x20) {
+				return Fail (i, "Control character in string");
+			}
+		}
+		return Fail (pos, "Unterminated string");
+	}
+
+	bool Document::ScanNumber (std::size_t& pos)
+	{
+		const std::size_t size = source.size ();
+		const char* data = source.data ();
+		std::size_t i = pos;
+		if (i < size && data[i] == '-')
+			++i;
+		if (i >= size || !IsDigit (data[i]))
+			return Fail (pos, "Invalid number");
+		if (data[i] == '0') {
+			++i;
+		} else {
+			while (i < size && IsDigit (data[i]))
+				++i;
+		}
+		if (i < size && data[i] == '.') {
+			++i;
+			if (i >= size || !IsDigit (data[i]))
+				return Fail (i, "Invalid number fraction");
+			while (i < size && IsDigit (data[i]))
+				++i;
+		}
+		if (i < size && (data[i] == 'e' || data[i] == 'E')) {
+			++i;
+			if (i < size && (data[i] == '+' || data[i] == '-'))
+				++i;
+			if (i >= size || !IsDigit (data[i]))
+				return Fail (i, "Invalid number exponent");
+			while (i < size && IsDigit (data[i]))
+				++i;
+		}
+		pos = i;
+		return true;
+	}
+
+	bool Document::ScanLiteral (std::size_t& pos, const char* literal, std::size_t literalLength)
+	{
+		if (source.compare (pos, literalLength, literal) != 0)
+			return Fail (pos, "Invalid literal");
+		pos += literalLength;
+		return true;
+	}
+
+	bool Document::Parse (const char* data, std::size_t length)
+	{
+		source.assign (data, length);
+		nodes.clear ();
+		errorOffset = 0;
+		errorMessage = nullptr;
+
+		if (length >= NoNode)
+			return Fail (0, "Input too large");
+
+		// Rough upper bound guess to avoid regrowth on point-heavy payloads
+		nodes.reserve (length / 6 + 1);
+
+		std::vector<std::uint32_t> stack;
+		State state = State::Value;
+		bool hasRoot = false;
+		std::uint32_t keyBegin = 0;
+		std::uint32_t keyEnd = 0;
+		bool keyEscaped = false;
+
+		const std::size_t size = source.size ();
+		std::size_t pos = 0;
+
+		for (;;) {
+			while (pos < size && IsWhitespace (source[pos]))
+				++pos;
+
+			if (stack.empty () && hasRoot) {
+				if (pos != size)
+					return Fail (pos, "Unexpected trailing characters");
+				break;
+			}
+			if (pos >= size)
+				return Fail (pos, "Unexpected end of input");
+
+			const char c = source[pos];
+
+			if (!stack.empty ()) {
+				Node& top = nodes[stack.back ()];
+				const bool inObject = (top.type == Type::Object);
+				const char closing = inObject ? '}' : ']';
+
+				if (state == State::CommaOrClose || state == State::KeyOrClose || state == State::ValueOrClose) {
+					if (c == closing) {
+						top.end = (std::uint32_t)(pos + 1);
+						stack.pop_back ();
+						state = State::CommaOrClose;
+						++pos;
+						continue;
+					}
+					if (state == State::CommaOrClose) {
+						if (c != ',')
+							return Fail (pos, inObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+						state = inObject ? State::Key : State::Value;
+						++pos;
+						continue;
+					}
+					state = inObject ? State::Key : State::Value;
+				}
+
+				if (state == State::Key) {
+					if (c != '"')
+						return Fail (pos, "Expected object key");
+					std::size_t keyPos = pos;
+					if (!ScanString (keyPos, keyEscaped))
+						return false;
+					keyBegin = (std::uint32_t)(pos + 1);
+					keyEnd = (std::uint32_t)(keyPos - 1);
+					pos = keyPos;
+					while (pos < size && IsWhitespace (source[pos]))
+						++pos;
+					if (pos >= size || source[pos] != ':')
+						return Fail (pos, "Expected ':' after object key");
+					++pos;
+					state = State::Value;
+					continue;
+				}
+			}
+
+			// state == Value: create the node and link it into its parent
+			const std::uint32_t index = (std::uint32_t)nodes.size ();
+			nodes.emplace_back ();
+			if (!stack.empty ()) {
+				Node& parent = nodes[stack.back ()];
+				if (parent.type == Type::Object) {
+					nodes[index].keyBegin = keyBegin;
+					nodes[index].keyEnd = keyEnd;
+					nodes[index].keyEscaped = keyEscaped;
+				}
+				if (parent.lastChild == NoNode)
+					parent.firstChild = index;
+				else
+					nodes[parent.lastChild].next = index;
+				parent.lastChild = index;
+				++parent.childCount;
+			}
+			hasRoot = true;
+
+			Node& node = nodes[index];
+			node.begin = (std::uint32_t)pos;
+			switch (c) {
+				case '{':
+				case '[':
+					node.type = (c == '{') ? Type::Object : Type::Array;
+					stack.push_back (index);
+					state = (c == '{') ? State::KeyOrClose : State::ValueOrClose;
+					++pos;
+					continue;
+				case '"': {
+					bool escaped = false;
+					std::size_t end = pos;
+					if (!ScanString (end, escaped))
+						return false;
+					Node& str = nodes[index];
+					str.type = Type::String;
+					str.escaped = escaped;
+					str.begin = (std::uint32_t)(pos + 1);
+					str.end = (std::uint32_t)(end - 1);
+					pos = end;
+					break;
+				}
+				case 't':
+					node.type = Type::Bool;
+					if (!ScanLiteral (pos, "true", 4))
+						return false;
+					nodes[index].end = (std::uint32_t)pos;
+					break;
+				case 'f':
+					node.type = Type::Bool;
+					if (!ScanLiteral (pos, "false", 5))
+						return false;
+					nodes[index].end = (std::uint32_t)pos;
+					break;
+				case 'n':
+					node.type = Type::Null;
+					if (!ScanLiteral (pos, "null", 4))
+						return false;
+					nodes[index].end = (std::uint32_t)pos;
+					break;
+				default:
+					node.type = Type::Number;
+					if (!ScanNumber (pos))
+						return false;
+					nodes[index].end = (std::uint32_t)pos;
+					break;
+			}
+			state = State::CommaOrClose;
+		}
+
+		return true;
+	}
+
+	Value Document::GetRoot () const
+	{
+		if (nodes.empty ())
+			return Value ();
+		return Value (this, 0);
+	}
+
+	// -------------------------------------------------------------------------
+	// Value
+	// -------------------------------------------------------------------------
+
+	Type Value::GetType () const
+	{
+		return doc->nodes[index].type;
+	}
+
+	Value Value::Find (std::string_view key) const
+	{
+		if (!IsObject ())
+			return Value ();
+
+		std::string unescaped;
+		for (std::uint32_t i = doc->nodes[index].firstChild; i != Document::NoNode; i = doc->nodes[i].next) {
+			const Document::Node& child = doc->nodes[i];
+			std::string_view rawKey = doc->Slice (child.keyBegin, child.keyEnd);
+			if (!child.keyEscaped) {
+				if (rawKey == key)
+					return Value (doc, i);
+			} else if (UnescapeString (rawKey, unescaped) && unescaped == key) {
+				return Value (doc, i);
+			}
+		}
+		return Value ();
+	}
+
+	std::uint32_t Value::GetSize () const
+	{
+		if (!IsObject () && !IsArray ())
+			return 0;
+		return doc->nodes[index].childCount;
+	}
+
+	Value Value::First () const
+	{
+		if (!IsObject () && !IsArray ())
+			return Value ();
+		std::uint32_t child = doc->nodes[index].firstChild;
+		return (child == Document::NoNode) ? Value () : Value (doc, child);
+	}
+
+	Value Value::Next () const
+	{
+		if (!IsValid ())
+			return Value ();
+		std::uint32_t sibling = doc->nodes[index].next;
+		return (sibling == Document::NoNode) ? Value () : Value (doc, sibling);
+	}
+
+	std::string Value::GetKey () const
+	{
+		if (!IsValid ())
+			return std::string ();
+		const Document::Node& node = doc->nodes[index];
+		std::string_view rawKey = doc->Slice (node.keyBegin, node.keyEnd);
+		if (!node.keyEscaped)
+			return std::string (rawKey);
+		std::string key;
+		UnescapeString (rawKey, key);
+		return key;
+	}
+
+	bool Value::GetString (std::string& out) const
+	{
+		if (!IsString ())
+			return false;
+		const Document::Node& node = doc->nodes[index];
+		std::string_view raw = doc->Slice (node.begin, node.end);
+		if (!node.escaped) {
+			out.assign (raw.data (), raw.size ());
+			return true;
+		}
+		return UnescapeString (raw, out);
+	}
+
+	bool Value::GetDouble (double& out) const
+	{
+		if (!IsNumber ())
+			return false;
+		const Document::Node& node = doc->nodes[index];
+		const char* data = doc->source.data ();
+		return NumberParser::ParseDouble (data + node.begin, data + node.end, out) != nullptr;
+	}
+
+	bool Value::GetBool (bool& out) const
+	{
+		if (!IsValid () || GetType () != Type::Bool)
+			return false;
+		out = (doc->source[doc->nodes[index].begin] == 't');
+		return true;
+	}
+
+	std::string_view Value::GetRaw () const
+	{
+		if (!IsValid ())
+			return std::string_view ();
+		const Document::Node& node = doc->nodes[index];
+		if (node.type == Type::String)
+			return doc->Slice (node.begin - 1, node.end + 1);
+		return doc->Slice (node.begin, node.end);
+	}
+
+} // namespace JsonReader
@@ -0,0 +1,133 @@
+// *****************************************************************************
+// Header file for JsonReader module (single-pass JSON tokenizer / DOM)
+// *****************************************************************************
+
+#ifndef JSONREADER_HPP
+#define JSONREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// The whole request is tokenized once into a flat node array. Values keep
+// byte offsets into the UTF-8 source instead of copies, so looking up keys
+// or reading numbers never rescans the request text.
+//
+// Pure C++ on purpose (no GS/ACAPI types) - can be compiled and timed
+// outside of Archicad.
+// -----------------------------------------------------------------------------
+
+namespace JsonReader {
+
+	enum class Type : std::uint8_t {
+		Null,
+		Bool,
+		Number,
+		String,
+		Object,
+		Array
+	};
+
+	class Document;
+
+	// -------------------------------------------------------------------------
+	// Lightweight handle to a node of a parsed Document
+	// Invalid handles are returned for missing keys; all getters fail on them
+	// -------------------------------------------------------------------------
+
+	class Value {
+	public:
+		Value () = default;
+
+		bool				IsValid () const	{ return doc != nullptr; }
+		Type				GetType () const;
+		bool				IsNull () const		{ return IsValid () && GetType () == Type::Null; }
+		bool				IsObject () const	{ return IsValid () && GetType () == Type::Object; }
+		bool				IsArray () const	{ return IsValid () && GetType () == Type::Array; }
+		bool				IsString () const	{ return IsValid () && GetType () == Type::String; }
+		bool				IsNumber () const	{ return IsValid () && GetType () == Type::Number; }
+
+		// Object member lookup (invalid Value if not an object or key is missing)
+		Value				Find (std::string_view key) const;
+		Value				operator[] (std::string_view key) const	{ return Find (key); }
+
+		// Children of objects and arrays, in document order
+		std::uint32_t		GetSize () const;
+		Value				First () const;
+		Value				Next () const;
+
+		// Member key of this node when it is an object member
+		std::string			GetKey () const;
+
+		bool				GetString (std::string& out) const;
+		bool				GetDouble (double& out) const;
+		bool				GetBool (bool& out) const;
+
+		// Raw source text of the value (including quotes/braces)
+		std::string_view	GetRaw () const;
+
+	private:
+		friend class Document;
+
+		Value (const Document* doc, std::uint32_t index) : doc (doc), index (index) {}
+
+		const Document*		doc = nullptr;
+		std::uint32_t		index = 0;
+	};
+
+	// -------------------------------------------------------------------------
+	// Parsed document - owns a copy of the source bytes and the node array
+	// -------------------------------------------------------------------------
+
+	class Document {
+	public:
+		// Tokenize the whole input in one pass; returns false on malformed JSON
+		bool				Parse (const char* data, std::size_t length);
+		bool				Parse (std::string_view text)	{ return Parse (text.data (), text.size ()); }
+
+		Value				GetRoot () const;
+
+		std::size_t			GetErrorOffset () const		{ return errorOffset; }
+		const char*			GetErrorMessage () const	{ return errorMessage; }
+
+	private:
+		friend class Value;
+
+		static constexpr std::uint32_t NoNode = 0xFFFFFFFFu;
+
+		struct Node {
+			Type			type = Type::Null;
+			bool			escaped = false;		// string value contains escape sequences
+			bool			keyEscaped = false;		// member key contains escape sequences
+			std::uint32_t	begin = 0;				// first byte of the value (inside quotes for strings)
+			std::uint32_t	end = 0;				// one past the last byte (closing quote for strings)
+			std::uint32_t	keyBegin = 0;			// member key span (inside quotes), objects only
+			std::uint32_t	keyEnd = 0;
+			std::uint32_t	firstChild = NoNode;
+			std::uint32_t	lastChild = NoNode;
+			std::uint32_t	next = NoNode;
+			std::uint32_t	childCount = 0;
+		};
+
+		bool				Fail (std::size_t offset, const char* message);
+		bool				ScanString (std::size_t& pos, bool& escaped);
+		bool				ScanNumber (std::size_t& pos);
+		bool				ScanLiteral (std::size_t& pos, const char* literal, std::size_t literalLength);
+
+		std::string_view	Slice (std::uint32_t begin, std::uint32_t end) const	{ return std::string_view (source.data () + begin, end - begin); }
+
+		std::string			source;
+		std::vector<Node>	nodes;
+		std::size_t			errorOffset = 0;
+		const char*			errorMessage = nullptr;
+	};
+
+	// Decode a JSON string body (without quotes) into UTF-8, resolving escapes
+	bool	UnescapeString (std::string_view raw, std::string& out);
+
+} // namespace JsonReader
+
+#endif // JSONREADER_HPP
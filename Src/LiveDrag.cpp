@@ -0,0 +1,212 @@
+// *****************************************************************************
+// Source code for LiveDrag module (coalesced hotspot moves while dragging)
+// *****************************************************************************
+
+#include "LiveDrag.hpp"
+#include "ChangeFeed.hpp"
+#include "EventLoop.hpp"
+#include "SpatialIndex.hpp"
+#include "UndoSession.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace LiveDrag {
+
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		constexpr double MinFrameRate = 1.0;
+		constexpr double MaxFrameRate = 120.0;
+
+		bool								g_enabled = false;
+		Clock::duration						g_frameInterval = std::chrono::milliseconds (33);
+		Clock::time_point					g_lastFlush;
+		Clock::time_point					g_lastSubmit;
+		GS::HashTable<API_Guid, API_Coord>	g_pending;		// hotspot -> latest requested position
+		GS::HashTable<API_Guid, API_Coord>	g_dragStart;	// hotspot moved by a frame -> position before the drag
+
+		bool GetHotspotPosition (const API_Guid& hotspotGuid, API_Coord& pos)
+		{
+			API_Element hotspot = {};
+			hotspot.header.guid = hotspotGuid;
+			if (ACAPI_Element_Get (&hotspot) != NoError || hotspot.header.type != API_HotspotID)
+				return false;		// deleted while dragging
+			pos = hotspot.hotspot.pos;
+			return true;
+		}
+
+		// Must be called from inside an UndoSession scope
+		bool SetHotspotPosition (const API_Guid& hotspotGuid, const API_Coord& pos)
+		{
+			API_Element mask = {};
+			ACAPI_ELEMENT_MASK_CLEAR (mask);
+			ACAPI_ELEMENT_MASK_SET (mask, API_HotspotType, pos);
+
+			API_Element hotspot = {};
+			hotspot.header.guid = hotspotGuid;
+			if (ACAPI_Element_Get (&hotspot) != NoError || hotspot.header.type != API_HotspotID)
+				return false;
+			hotspot.hotspot.pos = pos;
+			return ACAPI_Element_Change (&hotspot, &mask, nullptr, 0, true) == NoError;
+		}
+
+		// One frame of the drag - no undo step
+		void FlushFrame ()
+		{
+			g_lastFlush = Clock::now ();
+			if (g_pending.IsEmpty ())
+				return;
+
+			UndoSession::RunNotUndoable ("LiveDrag", [&]() -> GSErrCode {
+				for (auto it = g_pending.Begin (); it != g_pending.End (); ++it) {
+					API_Coord startPos = {};
+					const bool firstMove = !g_dragStart.ContainsKey (it->key);
+					if (firstMove && !GetHotspotPosition (it->key, startPos))
+						continue;
+					if (!SetHotspotPosition (it->key, it->value))
+						continue;
+					if (firstMove)
+						g_dragStart.Add (it->key, startPos);
+
+					SpatialIndex::SetHotspot (it->key, it->value);
+					ChangeFeed::Record (ChangeFeed::ChangeKind::Modified, it->key, API_HotspotID, &it->value);
+				}
+				return NoError;
+			});
+			g_pending.Clear ();
+		}
+
+		UInt32 MillisecondsUntil (Clock::time_point due)
+		{
+			const Clock::duration remaining = due - Clock::now ();
+			if (remaining <= Clock::duration::zero ())
+				return 0;
+			return (UInt32)std::chrono::duration_cast<std::chrono::milliseconds> (remaining).count () + 1;
+		}
+
+		// Runs from the event loop: writes the trailing frame, then ends the drag once it went idle
+		void Tick ()
+		{
+			if (!g_enabled)
+				return;
+
+			if (!g_pending.IsEmpty ()) {
+				const UInt32 frameDueMs = MillisecondsUntil (g_lastFlush + g_frameInterval);
+				if (frameDueMs == 0)
+					FlushFrame ();
+				EventLoop::ScheduleAfter (Tick, frameDueMs == 0 ? DragIdleMs : frameDueMs);
+			} else if (!g_dragStart.IsEmpty ()) {
+				const UInt32 idleDueMs = MillisecondsUntil (g_lastSubmit + std::chrono::milliseconds (DragIdleMs));
+				if (idleDueMs == 0)
+					Flush ();
+				else
+					EventLoop::ScheduleAfter (Tick, idleDueMs);
+			}
+		}
+	}
+
+	void SetEnabled (bool enabled, double frameRate)
+	{
+		const double rate = std::min (std::max (frameRate, MinFrameRate), MaxFrameRate);
+		g_frameInterval = std::chrono::duration_cast<Clock::duration> (std::chrono::duration<double> (1.0 / rate));
+		if (g_enabled && !enabled) {
+			Flush ();
+		}
+		g_enabled = enabled;
+		g_lastFlush = Clock::now ();
+	}
+
+	bool IsEnabled ()
+	{
+		return g_enabled;
+	}
+
+	bool Submit (const API_Guid& hotspotGuid, const API_Coord& pos)
+	{
+		if (g_pending.ContainsKey (hotspotGuid))
+			g_pending[hotspotGuid] = pos;
+		else
+			g_pending.Add (hotspotGuid, pos);
+
+		g_lastSubmit = Clock::now ();
+		if (g_lastSubmit - g_lastFlush < g_frameInterval) {
+			// The trailing frame is written by the tick if no request comes first
+			EventLoop::ScheduleAfter (Tick, GetMillisecondsToNextFlush ());
+			return false;
+		}
+
+		FlushFrame ();
+		// Ends the drag if no request comes
+		EventLoop::ScheduleAfter (Tick, DragIdleMs);
+		return true;
+	}
+
+	UInt32 Flush ()
+	{
+		g_lastFlush = Clock::now ();
+
+		// Final position of everything the drag touched: pending, or where the last frame put it
+		GS::HashTable<API_Guid, API_Coord> finalPositions = g_pending;
+		for (auto it = g_dragStart.Begin (); it != g_dragStart.End (); ++it) {
+			API_Coord pos = {};
+			if (!finalPositions.ContainsKey (it->key) && GetHotspotPosition (it->key, pos))
+				finalPositions.Add (it->key, pos);
+		}
+		if (finalPositions.IsEmpty ())
+			return 0;
+
+		// Undo of the drag must return to the positions it started from
+		if (!g_dragStart.IsEmpty ()) {
+			UndoSession::RunNotUndoable ("LiveDrag", [&]() -> GSErrCode {
+				for (auto it = g_dragStart.Begin (); it != g_dragStart.End (); ++it)
+					SetHotspotPosition (it->key, it->value);
+				return NoError;
+			});
+		}
+
+		UInt32 movedCount = 0;
+		UndoSession::RunUndoable ("LiveDrag", [&]() -> GSErrCode {
+			for (auto it = finalPositions.Begin (); it != finalPositions.End (); ++it) {
+				if (!SetHotspotPosition (it->key, it->value))
+					continue;
+
+				SpatialIndex::SetHotspot (it->key, it->value);
+				ChangeFeed::Record (ChangeFeed::ChangeKind::Modified, it->key, API_HotspotID, &it->value);
+				++movedCount;
+			}
+			return NoError;
+		});
+		g_pending.Clear ();
+		g_dragStart.Clear ();
+		return movedCount;
+	}
+
+	UInt32 GetPendingCount ()
+	{
+		return g_pending.GetSize ();
+	}
+
+	UInt32 GetMillisecondsToNextFlush ()
+	{
+		return MillisecondsUntil (g_lastFlush + g_frameInterval);
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close:
+			case APINotify_Quit:
+				g_pending.Clear ();
+				g_dragStart.Clear ();
+				g_enabled = false;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+} // namespace LiveDrag
@@ -0,0 +1,52 @@
+// *****************************************************************************
+// Header file for LiveDrag module (coalesced hotspot moves while dragging)
+// *****************************************************************************
+
+#ifndef LIVEDRAG_HPP
+#define LIVEDRAG_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// While a Grasshopper slider is dragged, UpdateHotspot requests arrive far
+// faster than the plan can redraw. In live-drag mode they only go into a
+// last-writer-wins table keyed by hotspot; the table is written to the
+// database at most frameRate times per second, so intermediate positions are
+// simply dropped.
+//
+// Frames are written without an undo step of their own. A drag ends when
+// live-drag is switched off, on FlushLiveDrag, or after DragIdleMs without
+// new positions: the moved hotspots are put back where the drag found them
+// and the final positions are written in one undoable change, so one drag is
+// one undo step. The trailing frame and the end of the drag are scheduled
+// from the Archicad event loop (EventLoop) and need no further request.
+// -----------------------------------------------------------------------------
+
+namespace LiveDrag {
+
+	constexpr double DefaultFrameRate = 30.0;
+	constexpr UInt32 DragIdleMs = 500;
+
+	// Turning live-drag off ends the drag
+	void		SetEnabled (bool enabled, double frameRate = DefaultFrameRate);
+	bool		IsEnabled ();
+
+	// Remember the latest position; writes a frame if the frame interval has passed
+	// Returns true if this call wrote a frame
+	bool		Submit (const API_Guid& hotspotGuid, const API_Coord& pos);
+
+	// End the drag: write the final positions in one undo step; returns the number of moved hotspots
+	UInt32		Flush ();
+
+	UInt32		GetPendingCount ();
+
+	// Time until a Submit would write a frame (0 if now)
+	UInt32		GetMillisecondsToNextFlush ();
+
+	// Forward project events (APINotify_*) - pending moves never outlive their project
+	void		OnProjectEvent (API_NotifyEventID notifID);
+
+} // namespace LiveDrag
+
+#endif // LIVEDRAG_HPP
@@ -12,6 +12,17 @@
 #include	"ACAPinc.h"		// also includes APIdefs.h
 #include	"BrowserPalette.hpp"
 #include	"DimensionCommands.hpp"
+#include	"DimensionHelper.hpp"
+#include	"ElementTracker.hpp"
+#include	"ChangeFeed.hpp"
+#include	"UndoSession.hpp"
+#include	"LiveDrag.hpp"
+#include	"SpatialIndex.hpp"
+#include	"TrackingStore.hpp"
+#include	"JobQueue.hpp"
+#include	"HotspotSweeper.hpp"
+#include	"DefaultsCache.hpp"
+#include	"EventLoop.hpp"
 
 // -----------------------------------------------------------------------------
 // Show or Hide Browser Palette
@@ -28,6 +39,41 @@ static void	ShowOrHideBrowserPalette ()
 	}
 }
 
+// -----------------------------------------------------------------------------
+// Project event handler
+//		single handler for the whole add-on (one handler per add-on is kept by
+//		Archicad), dispatches to the palette and the element tracker
+// -----------------------------------------------------------------------------
+
+static GSErrCode ProjectEventHandler (API_NotifyEventID notifID, Int32 /*param*/)
+{
+	// First: drops the maps of the previous project while the others still see it
+	TrackingStore::OnProjectEvent (notifID);
+	ElementTracker::OnProjectEvent (notifID);
+	ChangeFeed::OnProjectEvent (notifID);
+	UndoSession::OnProjectEvent (notifID);
+	LiveDrag::OnProjectEvent (notifID);
+	SpatialIndex::OnProjectEvent (notifID);
+	HotspotSweeper::OnProjectEvent (notifID);
+	JobQueue::OnProjectEvent (notifID);
+	DefaultsCache::OnProjectEvent (notifID);
+
+	switch (notifID) {
+		case APINotify_New:
+		case APINotify_NewAndReset:
+		case APINotify_Open:
+		case APINotify_Close:
+		case APINotify_ReceiveChanges:
+			DimensionHelper::ClearHotspotCache ();
+			break;
+		case APINotify_Quit:
+			BrowserPalette::DestroyInstance ();
+			break;
+	}
+
+	return NoError;
+}		// ProjectEventHandler
+
 // -----------------------------------------------------------------------------
 // MenuCommandHandler
 //		called to perform the user-asked command
@@ -78,6 +124,11 @@ GSErrCode RegisterInterface (void)
 	if (DBERROR (err != NoError))
 		return err;
 
+	// Deferred work (live-drag frames, job chunks) runs through the add-on's own modul command
+	err = EventLoop::RegisterInterface ();
+	if (DBERROR (err != NoError))
+		return err;
+
 	return err;
 }		// RegisterInterface
 
@@ -97,6 +148,30 @@ GSErrCode Initialize (void)
 	if (DBERROR (err != NoError))
 		return err;
 
+	// Tracked hotspots/dimensions are validated from notifications - keep them coming
+	ACAPI_KeepInMemory (true);
+
+	err = ACAPI_ProjectOperation_CatchProjectEvent (APINotify_New | APINotify_NewAndReset | APINotify_Open | APINotify_Close |
+													APINotify_Quit | APINotify_ReceiveChanges, ProjectEventHandler);
+	if (DBERROR (err != NoError))
+		return err;
+
+	err = ElementTracker::Initialize ();
+	if (DBERROR (err != NoError))
+		return err;
+
+	err = SpatialIndex::Initialize ();
+	if (DBERROR (err != NoError))
+		return err;
+
+	err = DefaultsCache::Initialize ();
+	if (DBERROR (err != NoError))
+		return err;
+
+	err = EventLoop::Initialize ();
+	if (DBERROR (err != NoError))
+		return err;
+
 	// Register DimensionGh commands for Grasshopper bridge
 	// Note: If registration fails, we continue - commands may not be available but add-on should still work
 	
@@ -110,37 +185,121 @@ GSErrCode Initialize (void)
 		// Command registration failed - log but don't fail initialization
 	}
 
-	// Temporarily disable other commands to test
-	// err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<GetDimensionsCommand> ());
-	// if (DBERROR (err != NoError)) {
-	// 	// Command registration failed - log but don't fail initialization
-	// }
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<GetDimensionsCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
 
 	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<CreateLinearDimensionCommand> ());
 	if (DBERROR (err != NoError)) {
 		// Command registration failed - log but don't fail initialization
 	}
 
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<CreateLinearDimensionsCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<CreateDimensionChainCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<SyncDimensionSetCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<GetChangesSinceCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<WaitForChangesCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
 	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<CreateHotspotCommand> ());
 	if (DBERROR (err != NoError)) {
 		// Command registration failed - log but don't fail initialization
 	}
 
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<UpsertHotspotsCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
 	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<UpdateHotspotCommand> ());
 	if (DBERROR (err != NoError)) {
 		// Command registration failed - log but don't fail initialization
 	}
 
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<GetDimensionSetCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<DeleteDimensionSetCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<TransformHotspotsCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
 	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<DeleteHotspotCommand> ());
 	if (DBERROR (err != NoError)) {
 		// Command registration failed - log but don't fail initialization
 	}
 
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<SweepHotspotsCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
 	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<DeleteAllHotspotsCommand> ());
 	if (DBERROR (err != NoError)) {
 		// Command registration failed - log but don't fail initialization
 	}
 
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<BeginSessionCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<CommitSessionCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<SetLiveDragCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<FlushLiveDragCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<SubmitJobCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<GetJobStatusCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
+	err = ACAPI_AddOnAddOnCommunication_InstallAddOnCommandHandler (GS::NewOwned<CancelJobCommand> ());
+	if (DBERROR (err != NoError)) {
+		// Command registration failed - log but don't fail initialization
+	}
+
 	return err;
 }		// Initialize
 
@@ -152,7 +311,13 @@ GSErrCode Initialize (void)
 
 GSErrCode FreeData (void)
 {
-	// Clean up all created hotspots when add-on is unloaded
-	HotspotManager::DeleteAllTrackedHotspots();
+	// Release long-polling WaitForChanges requests
+	ChangeFeed::Shutdown ();
+	EventLoop::Shutdown ();
+
+	// Forget the tracking only - deleting every hotspot here would be one big unrecorded
+	// edit at quit; orphans are collected chunk by chunk while running (HotspotSweeper)
+	DimensionManager::ClearAllDimensions();
+	HotspotManager::ClearAllHotspots();
 	return NoError;
 }		// FreeData
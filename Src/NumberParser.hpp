@@ -0,0 +1,23 @@
+// *****************************************************************************
+// Header file for NumberParser module (locale-independent double parsing)
+// *****************************************************************************
+
+#ifndef NUMBERPARSER_HPP
+#define NUMBERPARSER_HPP
+
+// -----------------------------------------------------------------------------
+// Parses JSON numbers straight from UTF-8 bytes: no allocation, no locale
+// (always '.' as decimal separator) and correctly rounded to the nearest
+// double (Clinger fast path + Eisel-Lemire, see NumberParser.cpp).
+// -----------------------------------------------------------------------------
+
+namespace NumberParser {
+
+	// Parse a number at the start of [first, last)
+	// Grammar: -?digits(.digits)?([eE][+-]?digits)?
+	// Returns the position after the number, or nullptr if there is no valid number
+	const char*		ParseDouble (const char* first, const char* last, double& value);
+
+} // namespace NumberParser
+
+#endif // NUMBERPARSER_HPP
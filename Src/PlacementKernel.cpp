@@ -0,0 +1,142 @@
+// *****************************************************************************
+// Source code for PlacementKernel module (batch base-line geometry)
+// *****************************************************************************
+
+#include "PlacementKernel.hpp"
+#include <cmath>
+
+#if defined(__AVX__)
+	#define PLACEMENTKERNEL_SIMD_AVX
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PLACEMENTKERNEL_SIMD_SSE2
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define PLACEMENTKERNEL_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace PlacementKernel {
+
+	namespace {
+		// Reference for the SIMD lanes below - keep the operation order in sync
+		void ComputeScalar (const LineInputs& in, const LinePlacements& out, size_t begin, size_t count)
+		{
+			for (size_t i = begin; i < count; ++i) {
+				const double dx = in.x2[i] - in.x1[i];
+				const double dy = in.y2[i] - in.y1[i];
+				const double len = std::sqrt (dx * dx + dy * dy);
+				const bool degenerate = !(len >= MinLength);
+				const double invLen = degenerate ? 0.0 : 1.0 / len;
+				const double px = -dy * invLen;
+				const double py = dx * invLen;
+				const double offset = (std::abs (in.offset[i]) > MinOffset) ? in.offset[i] : 0.0;
+
+				out.dirX[i] = dx;
+				out.dirY[i] = dy;
+				out.perpX[i] = px;
+				out.perpY[i] = py;
+				out.refX[i] = in.x1[i] + px * offset;
+				out.refY[i] = in.y1[i] + py * offset;
+				out.length[i] = len;
+				out.degenerate[i] = degenerate ? 1 : 0;
+			}
+		}
+	}
+
+	void ComputePlacements (const LineInputs& in, const LinePlacements& out, size_t count)
+	{
+		size_t i = 0;
+
+#if defined(PLACEMENTKERNEL_SIMD_AVX)
+		const __m256d minLength = _mm256_set1_pd (MinLength);
+		const __m256d minOffset = _mm256_set1_pd (MinOffset);
+		const __m256d one = _mm256_set1_pd (1.0);
+		const __m256d signBit = _mm256_set1_pd (-0.0);
+		for (; i + 4 <= count; i += 4) {
+			const __m256d x1 = _mm256_loadu_pd (in.x1 + i);
+			const __m256d y1 = _mm256_loadu_pd (in.y1 + i);
+			const __m256d dx = _mm256_sub_pd (_mm256_loadu_pd (in.x2 + i), x1);
+			const __m256d dy = _mm256_sub_pd (_mm256_loadu_pd (in.y2 + i), y1);
+			const __m256d len = _mm256_sqrt_pd (_mm256_add_pd (_mm256_mul_pd (dx, dx), _mm256_mul_pd (dy, dy)));
+			const __m256d valid = _mm256_cmp_pd (len, minLength, _CMP_GE_OQ);
+			const __m256d invLen = _mm256_and_pd (_mm256_div_pd (one, len), valid);
+			const __m256d px = _mm256_mul_pd (_mm256_xor_pd (dy, signBit), invLen);
+			const __m256d py = _mm256_mul_pd (dx, invLen);
+			const __m256d rawOffset = _mm256_loadu_pd (in.offset + i);
+			const __m256d offset = _mm256_and_pd (rawOffset, _mm256_cmp_pd (_mm256_andnot_pd (signBit, rawOffset), minOffset, _CMP_GT_OQ));
+
+			_mm256_storeu_pd (out.dirX + i, dx);
+			_mm256_storeu_pd (out.dirY + i, dy);
+			_mm256_storeu_pd (out.perpX + i, px);
+			_mm256_storeu_pd (out.perpY + i, py);
+			_mm256_storeu_pd (out.refX + i, _mm256_add_pd (x1, _mm256_mul_pd (px, offset)));
+			_mm256_storeu_pd (out.refY + i, _mm256_add_pd (y1, _mm256_mul_pd (py, offset)));
+			_mm256_storeu_pd (out.length + i, len);
+			const int validBits = _mm256_movemask_pd (valid);
+			for (int lane = 0; lane < 4; ++lane) {
+				out.degenerate[i + lane] = (validBits & (1 << lane)) ? 0 : 1;
+			}
+		}
+#elif defined(PLACEMENTKERNEL_SIMD_SSE2)
+		const __m128d minLength = _mm_set1_pd (MinLength);
+		const __m128d minOffset = _mm_set1_pd (MinOffset);
+		const __m128d one = _mm_set1_pd (1.0);
+		const __m128d signBit = _mm_set1_pd (-0.0);
+		for (; i + 2 <= count; i += 2) {
+			const __m128d x1 = _mm_loadu_pd (in.x1 + i);
+			const __m128d y1 = _mm_loadu_pd (in.y1 + i);
+			const __m128d dx = _mm_sub_pd (_mm_loadu_pd (in.x2 + i), x1);
+			const __m128d dy = _mm_sub_pd (_mm_loadu_pd (in.y2 + i), y1);
+			const __m128d len = _mm_sqrt_pd (_mm_add_pd (_mm_mul_pd (dx, dx), _mm_mul_pd (dy, dy)));
+			const __m128d valid = _mm_cmpge_pd (len, minLength);
+			const __m128d invLen = _mm_and_pd (_mm_div_pd (one, len), valid);
+			const __m128d px = _mm_mul_pd (_mm_xor_pd (dy, signBit), invLen);
+			const __m128d py = _mm_mul_pd (dx, invLen);
+			const __m128d rawOffset = _mm_loadu_pd (in.offset + i);
+			const __m128d offset = _mm_and_pd (rawOffset, _mm_cmpgt_pd (_mm_andnot_pd (signBit, rawOffset), minOffset));
+
+			_mm_storeu_pd (out.dirX + i, dx);
+			_mm_storeu_pd (out.dirY + i, dy);
+			_mm_storeu_pd (out.perpX + i, px);
+			_mm_storeu_pd (out.perpY + i, py);
+			_mm_storeu_pd (out.refX + i, _mm_add_pd (x1, _mm_mul_pd (px, offset)));
+			_mm_storeu_pd (out.refY + i, _mm_add_pd (y1, _mm_mul_pd (py, offset)));
+			_mm_storeu_pd (out.length + i, len);
+			const int validBits = _mm_movemask_pd (valid);
+			out.degenerate[i] = (validBits & 1) ? 0 : 1;
+			out.degenerate[i + 1] = (validBits & 2) ? 0 : 1;
+		}
+#elif defined(PLACEMENTKERNEL_SIMD_NEON)
+		const float64x2_t minLength = vdupq_n_f64 (MinLength);
+		const float64x2_t minOffset = vdupq_n_f64 (MinOffset);
+		for (; i + 2 <= count; i += 2) {
+			const float64x2_t x1 = vld1q_f64 (in.x1 + i);
+			const float64x2_t y1 = vld1q_f64 (in.y1 + i);
+			const float64x2_t dx = vsubq_f64 (vld1q_f64 (in.x2 + i), x1);
+			const float64x2_t dy = vsubq_f64 (vld1q_f64 (in.y2 + i), y1);
+			// No fused multiply-add: the scalar tail must round the same way
+			const float64x2_t len = vsqrtq_f64 (vaddq_f64 (vmulq_f64 (dx, dx), vmulq_f64 (dy, dy)));
+			const uint64x2_t valid = vcgeq_f64 (len, minLength);
+			const float64x2_t invLen = vreinterpretq_f64_u64 (vandq_u64 (vreinterpretq_u64_f64 (vdivq_f64 (vdupq_n_f64 (1.0), len)), valid));
+			const float64x2_t px = vmulq_f64 (vnegq_f64 (dy), invLen);
+			const float64x2_t py = vmulq_f64 (dx, invLen);
+			const float64x2_t rawOffset = vld1q_f64 (in.offset + i);
+			const float64x2_t offset = vreinterpretq_f64_u64 (vandq_u64 (vreinterpretq_u64_f64 (rawOffset), vcgtq_f64 (vabsq_f64 (rawOffset), minOffset)));
+
+			vst1q_f64 (out.dirX + i, dx);
+			vst1q_f64 (out.dirY + i, dy);
+			vst1q_f64 (out.perpX + i, px);
+			vst1q_f64 (out.perpY + i, py);
+			vst1q_f64 (out.refX + i, vaddq_f64 (x1, vmulq_f64 (px, offset)));
+			vst1q_f64 (out.refY + i, vaddq_f64 (y1, vmulq_f64 (py, offset)));
+			vst1q_f64 (out.length + i, len);
+			out.degenerate[i] = vgetq_lane_u64 (valid, 0) ? 0 : 1;
+			out.degenerate[i + 1] = vgetq_lane_u64 (valid, 1) ? 0 : 1;
+		}
+#endif
+
+		ComputeScalar (in, out, i, count);
+	}
+
+} // namespace PlacementKernel
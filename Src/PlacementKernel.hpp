@@ -0,0 +1,53 @@
+// *****************************************************************************
+// Header file for PlacementKernel module (batch base-line geometry)
+// *****************************************************************************
+
+#ifndef PLACEMENTKERNEL_HPP
+#define PLACEMENTKERNEL_HPP
+
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Base lines of many two-point dimensions at once, in structure-of-arrays
+// layout so the kernel runs on SIMD lanes (AVX, SSE2 or NEON, whichever the
+// build targets, with a scalar loop for the tail and for other targets).
+// Every path uses the same operations in the same order, so a pair gives the
+// same result whichever lane computes it. This relies on the compiler not
+// fusing multiply-adds, so the file is built with -ffp-contract=off
+// (/fp:precise on Windows); Tests/PlacementKernelTest checks it.
+//
+// Plain C++ on doubles - no Archicad types - so it builds and runs anywhere.
+// -----------------------------------------------------------------------------
+
+namespace PlacementKernel {
+
+	// Pairs closer than this are degenerate: no direction, no offset
+	constexpr double	MinLength = 1e-6;
+	// Smaller offsets leave refC on the first point
+	constexpr double	MinOffset = 1e-6;
+
+	struct LineInputs {
+		const double*	x1 = nullptr;
+		const double*	y1 = nullptr;
+		const double*	x2 = nullptr;
+		const double*	y2 = nullptr;
+		const double*	offset = nullptr;
+	};
+
+	struct LinePlacements {
+		double*			dirX = nullptr;			// p2 - p1, not normalized
+		double*			dirY = nullptr;
+		double*			perpX = nullptr;		// unit perpendicular (-dirY, dirX) / length; 0 if degenerate
+		double*			perpY = nullptr;
+		double*			refX = nullptr;			// p1 + perp * offset
+		double*			refY = nullptr;
+		double*			length = nullptr;
+		unsigned char*	degenerate = nullptr;	// 1 if length < MinLength
+	};
+
+	// Fill out[0, count) from in[0, count); arrays must not overlap
+	void ComputePlacements (const LineInputs& in, const LinePlacements& out, size_t count);
+
+} // namespace PlacementKernel
+
+#endif // PLACEMENTKERNEL_HPP
@@ -0,0 +1,467 @@
+// *****************************************************************************
+// Source code for SpatialIndex module (coordinate -> element resolution)
+// *****************************************************************************
+
+#include "SpatialIndex.hpp"
+#include "DefaultsCache.hpp"
+#include "ElementTracker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+namespace SpatialIndex {
+
+	namespace {
+		constexpr double	MinCellSize = 0.25;
+		constexpr double	MaxCellSize = 20.0;
+		constexpr double	PickTolerance = 1e-3;		// points on element edges still hit
+		constexpr Int64		MaxCellsPerElement = 1024;	// bigger boxes go to the "large" list
+		constexpr double	SamePointTolerance = 1e-9;	// a resolved point answers queries this close
+		constexpr size_t	MaxResolvedPerCell = 64;
+
+		struct ElementBox {
+			API_Guid	guid = APINULLGuid;
+			double		xMin = 0.0;
+			double		yMin = 0.0;
+			double		xMax = 0.0;
+			double		yMax = 0.0;
+			bool		alive = true;
+
+			// Straight walls and lines: the element lies within radius of the segment [a, b]
+			bool		hasSegment = false;
+			double		ax = 0.0;
+			double		ay = 0.0;
+			double		bx = 0.0;
+			double		by = 0.0;
+			double		radius = 0.0;
+		};
+
+		// Result of a database search, valid until an element whose box covers the cell changes
+		struct ResolvedPoint {
+			double		x = 0.0;
+			double		y = 0.0;
+			API_Guid	guid = APINULLGuid;
+		};
+
+		double SegmentDistance (const ElementBox& box, double x, double y)
+		{
+			const double dx = box.bx - box.ax;
+			const double dy = box.by - box.ay;
+			const double lengthSq = dx * dx + dy * dy;
+			double t = 0.0;
+			if (lengthSq > 0.0)
+				t = std::min (std::max (((x - box.ax) * dx + (y - box.ay) * dy) / lengthSq, 0.0), 1.0);
+			return std::hypot (x - (box.ax + t * dx), y - (box.ay + t * dy));
+		}
+
+		// ---------------------------------------------------------------------
+		// Uniform grid of element boxes; removals only mark entries dead
+		// ---------------------------------------------------------------------
+
+		class Grid {
+		public:
+			void Clear ()
+			{
+				entries.clear ();
+				cells.clear ();
+				largeEntries.clear ();
+				resolved.clear ();
+				deadCount = 0;
+			}
+
+			void SetCellSize (double size)
+			{
+				cellSize = std::min (std::max (size, MinCellSize), MaxCellSize);
+			}
+
+			UInt32 Insert (const ElementBox& box)
+			{
+				const UInt32 index = (UInt32)entries.size ();
+				entries.push_back (box);
+
+				if (IsLarge (box)) {
+					largeEntries.push_back (index);
+					resolved.clear ();
+					return index;
+				}
+				ForEachCell (box, [&] (Int64 key) {
+					cells[key].push_back (index);
+					resolved.erase (key);
+				});
+				return index;
+			}
+
+			void Remove (UInt32 index)
+			{
+				if (index < entries.size () && entries[index].alive) {
+					entries[index].alive = false;
+					++deadCount;
+					if (IsLarge (entries[index]))
+						resolved.clear ();
+					else
+						ForEachCell (entries[index], [&] (Int64 key) { resolved.erase (key); });
+				}
+			}
+
+			// True if any element may cover the point: its box contains the point and,
+			// for straight walls and lines, the point is near the segment
+			// A remaining candidate is not a hit - only the database search can tell
+			bool HasCandidate (double x, double y) const
+			{
+				auto contains = [&] (UInt32 index) {
+					const ElementBox& box = entries[index];
+					if (!box.alive ||
+						x < box.xMin - PickTolerance || x > box.xMax + PickTolerance ||
+						y < box.yMin - PickTolerance || y > box.yMax + PickTolerance)
+						return false;
+					return !box.hasSegment || SegmentDistance (box, x, y) <= box.radius + PickTolerance;
+				};
+
+				auto cell = cells.find (CellKey (CellCoord (x), CellCoord (y)));
+				if (cell != cells.end ()) {
+					for (UInt32 index : cell->second) {
+						if (contains (index))
+							return true;
+					}
+				}
+				for (UInt32 index : largeEntries) {
+					if (contains (index))
+						return true;
+				}
+				return false;
+			}
+
+			// Answer of an earlier search at the same point, if nothing around it changed since
+			bool FindResolved (double x, double y, API_Guid& guid) const
+			{
+				auto cell = resolved.find (CellKey (CellCoord (x), CellCoord (y)));
+				if (cell == resolved.end ())
+					return false;
+				for (const ResolvedPoint& point : cell->second) {
+					if (std::abs (point.x - x) <= SamePointTolerance && std::abs (point.y - y) <= SamePointTolerance) {
+						guid = point.guid;
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void AddResolved (double x, double y, const API_Guid& guid)
+			{
+				std::vector<ResolvedPoint>& points = resolved[CellKey (CellCoord (x), CellCoord (y))];
+				if (points.size () >= MaxResolvedPerCell)
+					points.erase (points.begin ());
+				points.push_back ({ x, y, guid });
+			}
+
+			bool NeedsCompaction () const
+			{
+				return deadCount > 1024 && deadCount * 2 > entries.size ();
+			}
+
+		private:
+			Int64 CellCoord (double v) const
+			{
+				return (Int64)std::floor (v / cellSize);
+			}
+
+			bool IsLarge (const ElementBox& box) const
+			{
+				const Int64 x0 = CellCoord (box.xMin - PickTolerance), x1 = CellCoord (box.xMax + PickTolerance);
+				const Int64 y0 = CellCoord (box.yMin - PickTolerance), y1 = CellCoord (box.yMax + PickTolerance);
+				return (x1 - x0 + 1) * (y1 - y0 + 1) > MaxCellsPerElement;
+			}
+
+			template <typename Visit>
+			void ForEachCell (const ElementBox& box, const Visit& visit) const
+			{
+				const Int64 x0 = CellCoord (box.xMin - PickTolerance), x1 = CellCoord (box.xMax + PickTolerance);
+				const Int64 y0 = CellCoord (box.yMin - PickTolerance), y1 = CellCoord (box.yMax + PickTolerance);
+				for (Int64 ix = x0; ix <= x1; ++ix) {
+					for (Int64 iy = y0; iy <= y1; ++iy)
+						visit (CellKey (ix, iy));
+				}
+			}
+
+			// Shifted as unsigned - left-shifting a negative signed value is undefined
+			static Int64 CellKey (Int64 ix, Int64 iy)
+			{
+				return (Int64)(((UInt64)ix << 32) ^ ((UInt64)iy & 0xFFFFFFFFull));
+			}
+
+			double										cellSize = 1.0;
+			std::vector<ElementBox>						entries;
+			std::unordered_map<Int64, std::vector<UInt32>>	cells;
+			std::vector<UInt32>							largeEntries;
+			std::unordered_map<Int64, std::vector<ResolvedPoint>>	resolved;
+			size_t										deadCount = 0;
+		};
+
+		Grid								g_grid;
+		bool								g_built = false;
+		GS::HashTable<API_Guid, UInt32>		g_elementIndex;		// element -> grid entry
+		GS::HashTable<API_Guid, API_Coord>	g_hotspots;			// hotspot -> position
+
+		const API_ElemFilterFlags IndexFilter = APIFilt_OnVisLayer | APIFilt_OnActFloor;
+
+		// Straight walls and lines are thin along a diagonal; their box alone would
+		// send most points of a dense plan to the database
+		void ReadElementSegment (const API_Elem_Head& header, ElementBox& box)
+		{
+			API_Element element = {};
+			element.header = header;
+			if (ACAPI_Element_Get (&element) != NoError)
+				return;
+
+			if (header.type == API_LineID) {
+				box.ax = element.line.begC.x;
+				box.ay = element.line.begC.y;
+				box.bx = element.line.endC.x;
+				box.by = element.line.endC.y;
+				box.radius = 0.0;
+				box.hasSegment = true;
+			} else if (element.wall.type != APIWtyp_Poly && std::abs (element.wall.angle) < 1e-9) {
+				// The body lies between offset and offset + thickness from the reference line, on either side
+				box.ax = element.wall.begC.x;
+				box.ay = element.wall.begC.y;
+				box.bx = element.wall.endC.x;
+				box.by = element.wall.endC.y;
+				box.radius = std::abs (element.wall.offset) + std::max (element.wall.thickness, element.wall.thickness1);
+				box.hasSegment = true;
+			}
+		}
+
+		// Bounding box of an element that SearchElementByCoord could return
+		// Hotspots and dimensions are skipped - they are never attachment targets
+		bool ReadElementBox (const API_Guid& guid, ElementBox& box)
+		{
+			API_Elem_Head header = {};
+			header.guid = guid;
+			if (ACAPI_Element_GetHeader (&header) != NoError)
+				return false;
+			if (header.type == API_HotspotID || header.type == API_DimensionID)
+				return false;
+
+			API_Box3D bounds = {};
+			if (ACAPI_Element_CalcBounds (&header, &bounds) != NoError)
+				return false;
+
+			box.guid = guid;
+			box.xMin = bounds.xMin;
+			box.yMin = bounds.yMin;
+			box.xMax = bounds.xMax;
+			box.yMax = bounds.yMax;
+			box.alive = true;
+			box.hasSegment = false;
+			if (header.type == API_WallID || header.type == API_LineID)
+				ReadElementSegment (header, box);
+			return true;
+		}
+
+		// Indexed elements are observed to hear about their changes and deletion
+		void ClearGrid ()
+		{
+			for (auto it = g_elementIndex.Begin (); it != g_elementIndex.End (); ++it)
+				ElementTracker::Unobserve (it->key);
+			g_grid.Clear ();
+			g_elementIndex.Clear ();
+			g_built = false;
+		}
+
+		void RemoveElement (const API_Guid& guid)
+		{
+			const UInt32* index = g_elementIndex.GetPtr (guid);
+			if (index == nullptr)
+				return;
+			g_grid.Remove (*index);
+			g_elementIndex.Delete (guid);
+			ElementTracker::Unobserve (guid);
+		}
+
+		void UpsertElement (const API_Guid& guid)
+		{
+			const UInt32* index = g_elementIndex.GetPtr (guid);
+			if (index != nullptr) {
+				g_grid.Remove (*index);
+				g_elementIndex.Delete (guid);
+			}
+			ElementBox box;
+			if (ACAPI_Element_Filter (guid, IndexFilter) && ReadElementBox (guid, box)) {
+				g_elementIndex.Add (guid, g_grid.Insert (box));
+				if (index == nullptr)
+					ElementTracker::Observe (guid);
+			} else if (index != nullptr) {
+				ElementTracker::Unobserve (guid);
+			}
+		}
+
+		bool Build ()
+		{
+			ClearGrid ();
+
+			GS::Array<API_Guid> guids;
+			if (ACAPI_Element_GetElemList (API_ZombieElemID, &guids, IndexFilter) != NoError)
+				return false;
+
+			std::vector<ElementBox> boxes;
+			boxes.reserve (guids.GetSize ());
+			double extentSum = 0.0;
+			for (const API_Guid& guid : guids) {
+				ElementBox box;
+				if (!ReadElementBox (guid, box))
+					continue;
+				extentSum += std::max (box.xMax - box.xMin, box.yMax - box.yMin);
+				boxes.push_back (box);
+			}
+
+			// Cell size follows the typical element extent on the story
+			g_grid.SetCellSize (boxes.empty () ? 1.0 : extentSum / boxes.size ());
+			for (const ElementBox& box : boxes) {
+				g_elementIndex.Add (box.guid, g_grid.Insert (box));
+				// Needed to hear about changes/deletions of elements we did not create
+				ElementTracker::Observe (box.guid);
+			}
+
+			g_built = true;
+			return true;
+		}
+
+		bool EnsureBuilt ()
+		{
+			if (g_built && g_grid.NeedsCompaction ())
+				g_built = false;
+			return g_built || Build ();
+		}
+
+		GSErrCode ViewEventHandler (const API_NotifyViewEventType* viewEvent)
+		{
+			if (viewEvent != nullptr && viewEvent->notifID == APINotify_ChangeFloor) {
+				ClearGrid ();
+				// Defaults carry the story new elements go to; one view event handler per add-on
+				DefaultsCache::Invalidate ();
+			}
+			return NoError;
+		}
+	}
+
+	GSErrCode Initialize ()
+	{
+		return ACAPI_Notification_CatchViewEvent (APINotify_ChangeFloor, API_ProjectMap, ViewEventHandler);
+	}
+
+	void OnElementEvent (const API_NotifyElementType& elemEvent)
+	{
+		const API_Guid& guid = elemEvent.elemHead.guid;
+
+		switch (elemEvent.notifID) {
+			case APINotifyElement_Delete:
+			case APINotifyElement_Undo_Created:
+			case APINotifyElement_Redo_Deleted:
+				g_hotspots.Delete (guid);
+				if (g_built)
+					RemoveElement (guid);
+				break;
+
+			case APINotifyElement_New:
+			case APINotifyElement_Copy:
+			case APINotifyElement_Change:
+			case APINotifyElement_Edit:
+			case APINotifyElement_Undo_Deleted:
+			case APINotifyElement_Undo_Modified:
+			case APINotifyElement_Redo_Created:
+			case APINotifyElement_Redo_Modified:
+				// Hotspot moved outside of our commands - reread position on demand
+				g_hotspots.Delete (guid);
+				if (g_built)
+					UpsertElement (guid);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close:
+			case APINotify_ReceiveChanges:
+				Invalidate ();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	void Invalidate ()
+	{
+		ClearGrid ();
+		g_hotspots.Clear ();
+	}
+
+	bool FindElementAt (const API_Coord& coord, API_Guid& elementGuid)
+	{
+		elementGuid = APINULLGuid;
+		const bool built = EnsureBuilt ();
+		if (built) {
+			// No element can be under the point - no database search needed
+			if (!g_grid.HasCandidate (coord.x, coord.y))
+				return false;
+			// Same point as an earlier query (a hotspot shared by several dimensions)
+			if (g_grid.FindResolved (coord.x, coord.y, elementGuid))
+				return elementGuid != APINULLGuid;
+		}
+
+		// Boxes over-approximate curved and non-convex elements: the exact answer is Archicad's
+		API_ElemSearchPars searchPars = {};
+		searchPars.type = API_ZombieElemID;
+		searchPars.loc = coord;
+		searchPars.z = 1.00E6;
+		searchPars.filterBits = IndexFilter;
+		if (ACAPI_Element_SearchElementByCoord (&searchPars, &elementGuid) != NoError)
+			elementGuid = APINULLGuid;
+		// Only answers the grid hears about stay valid: misses and indexed elements
+		if (built && (elementGuid == APINULLGuid || g_elementIndex.ContainsKey (elementGuid)))
+			g_grid.AddResolved (coord.x, coord.y, elementGuid);
+		return elementGuid != APINULLGuid;
+	}
+
+	void SetHotspot (const API_Guid& hotspotGuid, const API_Coord& pos)
+	{
+		if (hotspotGuid == APINULLGuid)
+			return;
+		if (g_hotspots.ContainsKey (hotspotGuid))
+			g_hotspots[hotspotGuid] = pos;
+		else
+			g_hotspots.Add (hotspotGuid, pos);
+	}
+
+	void RemoveHotspot (const API_Guid& hotspotGuid)
+	{
+		g_hotspots.Delete (hotspotGuid);
+	}
+
+	bool GetHotspotPosition (const API_Guid& hotspotGuid, API_Coord& pos)
+	{
+		const API_Coord* cached = g_hotspots.GetPtr (hotspotGuid);
+		if (cached != nullptr) {
+			pos = *cached;
+			return true;
+		}
+
+		API_Element hotspot = {};
+		hotspot.header.guid = hotspotGuid;
+		if (ACAPI_Element_Get (&hotspot) != NoError || hotspot.header.type != API_HotspotID)
+			return false;
+
+		pos = hotspot.hotspot.pos;
+		g_hotspots.Add (hotspotGuid, pos);
+		return true;
+	}
+
+} // namespace SpatialIndex
@@ -0,0 +1,50 @@
+// *****************************************************************************
+// Header file for SpatialIndex module (coordinate -> element resolution)
+// *****************************************************************************
+
+#ifndef SPATIALINDEX_HPP
+#define SPATIALINDEX_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// Uniform grid over the bounding boxes of the elements on the active story,
+// plus the positions of the hotspots created by this add-on.
+//
+// Saves per-point ACAPI_Element_SearchElementByCoord calls. A point outside
+// every box - or, for straight walls and lines, farther from the reference
+// line than the element reaches - has no element under it and is answered
+// from the grid. Other points are resolved by Archicad once; the answer is
+// kept in the grid cell and reused for the same point (hotspots shared by
+// several dimensions) until an element whose box covers the cell changes.
+// The grid is built lazily on the first query, kept up to date from element
+// notifications (indexed elements are observed through
+// ElementTracker::Observe), and rebuilt after story/project changes.
+// -----------------------------------------------------------------------------
+
+namespace SpatialIndex {
+
+	// Install notification handlers (new elements, story change) - call once from Initialize
+	GSErrCode	Initialize ();
+
+	// Forward element / project notifications
+	void		OnElementEvent (const API_NotifyElementType& elemEvent);
+	void		OnProjectEvent (API_NotifyEventID notifID);
+
+	// Drop everything; rebuilt on next query
+	void		Invalidate ();
+
+	// Element under the point - same answer as ACAPI_Element_SearchElementByCoord
+	// on visible layers/active story, without the search when the grid rules the point
+	// out or resolved the same point before
+	bool		FindElementAt (const API_Coord& coord, API_Guid& elementGuid);
+
+	// Positions of hotspots created by this add-on
+	void		SetHotspot (const API_Guid& hotspotGuid, const API_Coord& pos);
+	void		RemoveHotspot (const API_Guid& hotspotGuid);
+	bool		GetHotspotPosition (const API_Guid& hotspotGuid, API_Coord& pos);
+
+} // namespace SpatialIndex
+
+#endif // SPATIALINDEX_HPP
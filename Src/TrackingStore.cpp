@@ -0,0 +1,624 @@
+// *****************************************************************************
+// Source code for TrackingStore module (tracking maps persisted in the project)
+// *****************************************************************************
+
+#include "TrackingStore.hpp"
+#include "DimensionCommands.hpp"
+#include "ChangeFeed.hpp"
+#include "DimensionSets.hpp"
+#include "ElementTracker.hpp"
+#include "EventLoop.hpp"
+#include "SpatialIndex.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace TrackingStore {
+
+	namespace {
+		// One add-on object per bucket, named ObjectNamePrefix + bucket index.
+		// Layout (little-endian, as on every platform Archicad runs on):
+		//   UInt32 magic, UInt32 version
+		//   UInt32 n, n x { hotspot guid, rhino key (null if unmapped) }
+		//   UInt32 n, n x { dimension guid, UInt32 nodeCount, nodeCount x hotspot guid }
+		//   UInt32 n, n x { UInt32 byteCount, UTF-8 set id, UInt32 h, h x guid, UInt32 d, d x guid }
+		constexpr UInt32	Magic = 0x54484744;		// "DGHT"
+		constexpr UInt32	Version = 2;
+		const char*			ObjectNamePrefix = "DimensionGh.TrackingMaps.";
+
+		// Records per bucket; items are added to the open bucket in creation order, so the
+		// items of one batch share a few buckets and a save rewrites only those
+		constexpr UInt32	BucketCapacity = 2048;
+
+		// Stored records of one bucket; a record whose item is gone is dropped when the bucket is written
+		struct Bucket {
+			GS::HashSet<API_Guid>		hotspots;
+			GS::HashSet<API_Guid>		dimensions;
+			GS::HashSet<GS::UniString>	sets;
+
+			UInt32 GetSize () const { return hotspots.GetSize () + dimensions.GetSize () + sets.GetSize (); }
+		};
+
+		bool								g_needsLoad = true;		// the add-on may be loaded into an already open project
+		bool								g_loading = false;
+		bool								g_reloadScheduled = false;
+
+		GS::HashTable<UInt32, Bucket>			g_buckets;
+		GS::HashTable<API_Guid, UInt32>			g_hotspotBuckets;		// item -> bucket holding its record
+		GS::HashTable<API_Guid, UInt32>			g_dimensionBuckets;
+		GS::HashTable<GS::UniString, UInt32>	g_setBuckets;
+		GS::HashSet<UInt32>						g_dirtyBuckets;			// written by the next SaveInUndoScope
+		UInt32									g_openBucket = 0;		// receives new items
+		GS::HashSet<API_Guid>					g_released;				// records dropped since the maps were loaded
+
+		class Writer {
+		public:
+			void UInt (UInt32 value)			{ Append (&value, sizeof (value)); }
+			void Guid (const API_Guid& guid)	{ Append (&guid, sizeof (guid)); }
+
+			void String (const GS::UniString& value)
+			{
+				const auto utf8 = value.ToCStr (0, MaxUSize, CC_UTF8);
+				const UInt32 byteCount = (UInt32)strlen (utf8.Get ());
+				UInt (byteCount);
+				Append (utf8.Get (), byteCount);
+			}
+
+			const std::vector<char>& GetBytes () const { return bytes; }
+
+		private:
+			void Append (const void* data, size_t size)
+			{
+				const char* first = static_cast<const char*> (data);
+				bytes.insert (bytes.end (), first, first + size);
+			}
+
+			std::vector<char> bytes;
+		};
+
+		class Reader {
+		public:
+			Reader (const char* data, size_t size) : current (data), end (data + size) {}
+
+			bool UInt (UInt32& value)		{ return Read (&value, sizeof (value)); }
+			bool Guid (API_Guid& guid)		{ return Read (&guid, sizeof (guid)); }
+
+			// Element count that cannot exceed the remaining bytes - guards allocations against corrupt data
+			bool Count (UInt32& count, size_t minElementSize)
+			{
+				return UInt (count) && (size_t)count <= (size_t)(end - current) / minElementSize;
+			}
+
+			bool String (GS::UniString& value)
+			{
+				UInt32 byteCount = 0;
+				if (!Count (byteCount, 1)) {
+					return false;
+				}
+				const std::string utf8 (current, byteCount);
+				current += byteCount;
+				value = GS::UniString (utf8.c_str (), CC_UTF8);
+				return true;
+			}
+
+			bool IsAtEnd () const { return current == end; }
+
+		private:
+			bool Read (void* data, size_t size)
+			{
+				if ((size_t)(end - current) < size) {
+					return false;
+				}
+				memcpy (data, current, size);
+				current += size;
+				return true;
+			}
+
+			const char* current;
+			const char* end;
+		};
+
+		struct StoredHotspot {
+			API_Guid	hotspotGuid = APINULLGuid;
+			API_Guid	rhinoKey = APINULLGuid;
+		};
+
+		struct StoredDimension {
+			API_Guid			dimensionGuid = APINULLGuid;
+			GS::Array<API_Guid>	hotspots;
+		};
+
+		struct StoredSet {
+			GS::UniString			setId;
+			DimensionSets::Members	members;
+		};
+
+		bool ReadGuidSet (Reader& reader, GS::HashSet<API_Guid>& guids)
+		{
+			UInt32 count = 0;
+			if (!reader.Count (count, sizeof (API_Guid))) {
+				return false;
+			}
+			for (UInt32 i = 0; i < count; ++i) {
+				API_Guid guid = APINULLGuid;
+				if (!reader.Guid (guid)) {
+					return false;
+				}
+				guids.Add (guid);
+			}
+			return true;
+		}
+
+		void WriteGuidSet (Writer& writer, const GS::HashSet<API_Guid>& guids)
+		{
+			writer.UInt ((UInt32)guids.GetSize ());
+			for (const API_Guid& guid : guids) {
+				writer.Guid (guid);
+			}
+		}
+
+		// Write the records of the bucket whose items are still tracked; drop the others
+		void EncodeBucket (Writer& writer, Bucket& bucket)
+		{
+			writer.UInt (Magic);
+			writer.UInt (Version);
+
+			GS::Array<API_Guid> hotspots;
+			for (const API_Guid& hotspotGuid : bucket.hotspots) {
+				if (HotspotManager::IsTrackedHotspot (hotspotGuid)) {
+					hotspots.Push (hotspotGuid);
+				} else {
+					g_hotspotBuckets.Delete (hotspotGuid);
+					g_released.Add (hotspotGuid);
+				}
+			}
+			bucket.hotspots.Clear ();
+			writer.UInt ((UInt32)hotspots.GetSize ());
+			for (const API_Guid& hotspotGuid : hotspots) {
+				bucket.hotspots.Add (hotspotGuid);
+				writer.Guid (hotspotGuid);
+				writer.Guid (HotspotManager::FindRhinoKeyByHotspot (hotspotGuid));
+			}
+
+			GS::Array<API_Guid> dimensions;
+			for (const API_Guid& dimensionGuid : bucket.dimensions) {
+				if (DimensionManager::IsTrackedDimension (dimensionGuid)) {
+					dimensions.Push (dimensionGuid);
+				} else {
+					g_dimensionBuckets.Delete (dimensionGuid);
+					g_released.Add (dimensionGuid);
+				}
+			}
+			bucket.dimensions.Clear ();
+			writer.UInt ((UInt32)dimensions.GetSize ());
+			for (const API_Guid& dimensionGuid : dimensions) {
+				const GS::Array<API_Guid> nodes = DimensionManager::GetHotspotsForDimension (dimensionGuid);
+				bucket.dimensions.Add (dimensionGuid);
+				writer.Guid (dimensionGuid);
+				writer.UInt ((UInt32)nodes.GetSize ());
+				for (const API_Guid& hotspotGuid : nodes) {
+					writer.Guid (hotspotGuid);
+				}
+			}
+
+			GS::Array<GS::UniString> setIds;
+			for (const GS::UniString& setId : bucket.sets) {
+				if (DimensionSets::Get (setId) != nullptr) {
+					setIds.Push (setId);
+				} else {
+					g_setBuckets.Delete (setId);
+				}
+			}
+			bucket.sets.Clear ();
+			writer.UInt ((UInt32)setIds.GetSize ());
+			for (const GS::UniString& setId : setIds) {
+				const DimensionSets::Members* members = DimensionSets::Get (setId);
+				bucket.sets.Add (setId);
+				writer.String (setId);
+				WriteGuidSet (writer, members->hotspots);
+				WriteGuidSet (writer, members->dimensions);
+			}
+		}
+
+		// All or nothing: nothing is applied unless the whole object decodes
+		bool Decode (Reader& reader, GS::Array<StoredHotspot>& hotspots, GS::Array<StoredDimension>& dimensions, GS::Array<StoredSet>& sets)
+		{
+			UInt32 magic = 0;
+			UInt32 version = 0;
+			if (!reader.UInt (magic) || magic != Magic || !reader.UInt (version) || version != Version) {
+				return false;
+			}
+
+			UInt32 count = 0;
+			if (!reader.Count (count, 2 * sizeof (API_Guid))) {
+				return false;
+			}
+			hotspots.SetCapacity (count);
+			for (UInt32 i = 0; i < count; ++i) {
+				StoredHotspot hotspot;
+				if (!reader.Guid (hotspot.hotspotGuid) || !reader.Guid (hotspot.rhinoKey)) {
+					return false;
+				}
+				hotspots.Push (hotspot);
+			}
+
+			if (!reader.Count (count, sizeof (API_Guid) + sizeof (UInt32))) {
+				return false;
+			}
+			dimensions.SetCapacity (count);
+			for (UInt32 i = 0; i < count; ++i) {
+				StoredDimension dimension;
+				UInt32 nodeCount = 0;
+				if (!reader.Guid (dimension.dimensionGuid) || !reader.Count (nodeCount, sizeof (API_Guid))) {
+					return false;
+				}
+				dimension.hotspots.SetCapacity (nodeCount);
+				for (UInt32 j = 0; j < nodeCount; ++j) {
+					API_Guid hotspotGuid = APINULLGuid;
+					if (!reader.Guid (hotspotGuid)) {
+						return false;
+					}
+					dimension.hotspots.Push (hotspotGuid);
+				}
+				dimensions.Push (dimension);
+			}
+
+			if (!reader.Count (count, 3 * sizeof (UInt32))) {
+				return false;
+			}
+			sets.SetCapacity (count);
+			for (UInt32 i = 0; i < count; ++i) {
+				StoredSet set;
+				if (!reader.String (set.setId) || !ReadGuidSet (reader, set.members.hotspots) || !ReadGuidSet (reader, set.members.dimensions)) {
+					return false;
+				}
+				sets.Push (set);
+			}
+			return reader.IsAtEnd ();
+		}
+
+		// Bucket holding the record of the item; new items go to the open bucket
+		template <typename Key>
+		UInt32 AssignBucket (GS::HashTable<Key, UInt32>& itemBuckets, const Key& key)
+		{
+			const UInt32* index = itemBuckets.GetPtr (key);
+			if (index != nullptr) {
+				return *index;
+			}
+			Bucket* open = g_buckets.GetPtr (g_openBucket);
+			if (open == nullptr) {
+				g_buckets.Add (g_openBucket, Bucket ());
+			} else if (open->GetSize () >= BucketCapacity) {
+				++g_openBucket;
+				g_buckets.Add (g_openBucket, Bucket ());
+			}
+			itemBuckets.Add (key, g_openBucket);
+			return g_openBucket;
+		}
+
+		void MarkBucketDirty (UInt32 index)
+		{
+			if (!g_dirtyBuckets.Contains (index)) {
+				g_dirtyBuckets.Add (index);
+			}
+		}
+
+		// Bucket index from an object name, false for objects that are not buckets
+		bool ParseBucketName (const GS::UniString& name, UInt32& index)
+		{
+			const auto utf8 = name.ToCStr (0, MaxUSize, CC_UTF8);
+			const size_t prefixLength = strlen (ObjectNamePrefix);
+			if (strncmp (utf8.Get (), ObjectNamePrefix, prefixLength) != 0) {
+				return false;
+			}
+			char* end = nullptr;
+			const unsigned long value = strtoul (utf8.Get () + prefixLength, &end, 10);
+			if (end == utf8.Get () + prefixLength || *end != '\0') {
+				return false;
+			}
+			index = (UInt32)value;
+			return true;
+		}
+
+		void LoadBucket (UInt32 index, GSHandle content)
+		{
+			GS::Array<StoredHotspot> hotspots;
+			GS::Array<StoredDimension> dimensions;
+			GS::Array<StoredSet> sets;
+			Reader reader (*content, (size_t)BMhGetSize (content));
+			if (!Decode (reader, hotspots, dimensions, sets)) {
+				return;
+			}
+
+			Bucket bucket;
+			// Elements are not checked here: ElementTracker validates each one on first access
+			for (const StoredHotspot& hotspot : hotspots) {
+				HotspotManager::RestoreHotspot (hotspot.hotspotGuid, hotspot.rhinoKey);
+				bucket.hotspots.Add (hotspot.hotspotGuid);
+				g_hotspotBuckets.Add (hotspot.hotspotGuid, index);
+			}
+			for (const StoredDimension& dimension : dimensions) {
+				DimensionManager::AddDimensionChain (dimension.hotspots, dimension.dimensionGuid);
+				bucket.dimensions.Add (dimension.dimensionGuid);
+				g_dimensionBuckets.Add (dimension.dimensionGuid, index);
+			}
+			for (const StoredSet& set : sets) {
+				DimensionSets::Replace (set.setId, set.members);
+				bucket.sets.Add (set.setId);
+				g_setBuckets.Add (set.setId, index);
+			}
+			g_buckets.Add (index, bucket);
+		}
+
+		void Load ()
+		{
+			GS::Array<API_Guid> objects;
+			if (ACAPI_AddOnObject_GetObjectList (&objects) != NoError) {
+				return;
+			}
+
+			UInt32 lastIndex = 0;
+			bool any = false;
+			for (const API_Guid& objectGuid : objects) {
+				GS::UniString name;
+				GSHandle content = nullptr;
+				if (ACAPI_AddOnObject_GetObjectContent (objectGuid, &name, &content) != NoError || content == nullptr) {
+					continue;
+				}
+				UInt32 index = 0;
+				if (ParseBucketName (name, index) && !g_buckets.ContainsKey (index)) {
+					LoadBucket (index, content);
+					lastIndex = any ? std::max (lastIndex, index) : index;
+					any = true;
+				}
+				BMKillHandle (&content);
+			}
+			// Stored buckets are rewritten only when their own items change
+			g_openBucket = any ? lastIndex + 1 : 0;
+		}
+
+		void ForgetBuckets ()
+		{
+			g_buckets.Clear ();
+			g_hotspotBuckets.Clear ();
+			g_dimensionBuckets.Clear ();
+			g_setBuckets.Clear ();
+			g_dirtyBuckets.Clear ();
+			g_released.Clear ();
+			g_openBucket = 0;
+		}
+
+		// The maps no longer match the project; the stored ones are loaded on next access
+		// Quiet: clearing the maps is not a deletion of the elements, nothing goes to ChangeFeed
+		void DropMaps ()
+		{
+			g_needsLoad = false;
+			g_loading = true;
+			ElementTracker::SetRestoring (true);
+			DimensionManager::ClearAllDimensions ();
+			HotspotManager::ClearAllHotspots ();
+			DimensionSets::Clear ();
+			ElementTracker::SetRestoring (false);
+			g_loading = false;
+			ForgetBuckets ();
+			g_needsLoad = true;
+		}
+
+		// Alive tracked elements, as clients last heard of them
+		GS::HashTable<API_Guid, API_ElemTypeID> GetReportedElements ()
+		{
+			GS::HashTable<API_Guid, API_ElemTypeID> elements;
+			for (const API_Guid& hotspotGuid : HotspotManager::GetAllHotspots ()) {
+				if (ElementTracker::IsAlive (hotspotGuid, API_HotspotID)) {
+					elements.Add (hotspotGuid, API_HotspotID);
+				}
+			}
+			for (const API_Guid& dimensionGuid : DimensionManager::GetAllDimensions ()) {
+				if (ElementTracker::IsAlive (dimensionGuid, API_DimensionID)) {
+					elements.Add (dimensionGuid, API_DimensionID);
+				}
+			}
+			return elements;
+		}
+
+		// Reload from the project and report only what the reload changed: elements the
+		// restored maps track again (their notifications came while they were untracked)
+		// and elements they no longer track
+		void ReloadAndReport ()
+		{
+			if (g_needsLoad) {
+				return;		// nothing in memory to compare
+			}
+			const GS::HashTable<API_Guid, API_ElemTypeID> before = GetReportedElements ();
+			DropMaps ();
+			EnsureLoaded ();
+			GS::HashTable<API_Guid, API_ElemTypeID> after = GetReportedElements ();
+
+			for (auto it = after.Begin (); it != after.End (); ++it) {
+				if (before.ContainsKey (it->key)) {
+					continue;
+				}
+				API_Coord position = {};
+				const bool hasPosition = it->value == API_HotspotID && SpatialIndex::GetHotspotPosition (it->key, position);
+				ChangeFeed::Record (ChangeFeed::ChangeKind::Added, it->key, it->value, hasPosition ? &position : nullptr);
+			}
+			for (auto it = before.Begin (); it != before.End (); ++it) {
+				if (!after.ContainsKey (it->key)) {
+					ChangeFeed::Record (ChangeFeed::ChangeKind::Deleted, it->key, it->value);
+				}
+			}
+		}
+
+		void ReloadAfterUndo ()
+		{
+			g_reloadScheduled = false;
+			ReloadAndReport ();
+		}
+
+		// Elements whose undo / redo may restore a different stored state
+		bool AffectsStoredState (const API_Guid& guid)
+		{
+			return g_hotspotBuckets.ContainsKey (guid) || g_dimensionBuckets.ContainsKey (guid) || g_released.Contains (guid) ||
+				   HotspotManager::IsTrackedHotspot (guid) || DimensionManager::IsTrackedDimension (guid);
+		}
+	}
+
+	void EnsureLoaded ()
+	{
+		if (!g_needsLoad) {
+			return;
+		}
+		// Cleared first: the managers call back into EnsureLoaded while restoring
+		g_needsLoad = false;
+		g_loading = true;
+		ElementTracker::SetRestoring (true);
+		Load ();
+		ElementTracker::SetRestoring (false);
+		g_loading = false;
+	}
+
+	void MarkHotspotDirty (const API_Guid& hotspotGuid)
+	{
+		if (!g_loading) {
+			const UInt32 index = AssignBucket (g_hotspotBuckets, hotspotGuid);
+			g_buckets[index].hotspots.Add (hotspotGuid);
+			MarkBucketDirty (index);
+		}
+	}
+
+	void MarkDimensionDirty (const API_Guid& dimensionGuid)
+	{
+		if (!g_loading) {
+			const UInt32 index = AssignBucket (g_dimensionBuckets, dimensionGuid);
+			g_buckets[index].dimensions.Add (dimensionGuid);
+			MarkBucketDirty (index);
+		}
+	}
+
+	void MarkSetDirty (const GS::UniString& setId)
+	{
+		if (!g_loading) {
+			const UInt32 index = AssignBucket (g_setBuckets, setId);
+			g_buckets[index].sets.Add (setId);
+			MarkBucketDirty (index);
+		}
+	}
+
+	void MarkAllDirty ()
+	{
+		if (!g_loading) {
+			for (auto it = g_buckets.Begin (); it != g_buckets.End (); ++it) {
+				MarkBucketDirty (it->key);
+			}
+		}
+	}
+
+	bool HasUnsavedChanges ()
+	{
+		return !g_dirtyBuckets.IsEmpty ();
+	}
+
+	GSErrCode SaveInUndoScope ()
+	{
+		// Only the buckets holding changed items: O(changed buckets), not O(all tracked items)
+		while (!g_dirtyBuckets.IsEmpty ()) {
+			UInt32 index = 0;
+			for (const UInt32 dirtyIndex : g_dirtyBuckets) {
+				index = dirtyIndex;
+				break;
+			}
+
+			char objectName[64];
+			snprintf (objectName, sizeof (objectName), "%s%u", ObjectNamePrefix, (unsigned)index);
+			API_Guid objectGuid = APINULLGuid;
+			const bool stored = (ACAPI_AddOnObject_GetObjectGuidFromName (objectName, &objectGuid) == NoError);
+
+			Bucket* bucket = g_buckets.GetPtr (index);
+			Writer writer;
+			if (bucket != nullptr) {
+				EncodeBucket (writer, *bucket);
+			}
+
+			GSErrCode err = NoError;
+			if (bucket == nullptr || bucket->GetSize () == 0) {
+				// Every record of the bucket is gone
+				if (stored) {
+					err = ACAPI_AddOnObject_DeleteObject (objectGuid);
+				}
+				if (err == NoError && index != g_openBucket) {
+					g_buckets.Delete (index);
+				}
+			} else {
+				const std::vector<char>& bytes = writer.GetBytes ();
+				GSHandle content = BMAllocateHandle ((GSSize)bytes.size (), ALLOCATE_CLEAR, 0);
+				if (content == nullptr) {
+					return APIERR_MEMFULL;
+				}
+				memcpy (*content, bytes.data (), bytes.size ());
+				if (stored) {
+					err = ACAPI_AddOnObject_ModifyObject (objectGuid, nullptr, &content);
+				} else {
+					err = ACAPI_AddOnObject_CreateObject (objectName, content, &objectGuid);
+				}
+				BMKillHandle (&content);
+			}
+
+			if (err != NoError) {
+				return err;
+			}
+			g_dirtyBuckets.Delete (index);
+		}
+		return NoError;
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close:
+				// The maps belong to the previous project; the new one is loaded on first access
+				DropMaps ();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	void OnElementEvent (const API_NotifyElementType& elemEvent)
+	{
+		// Maps not loaded: the next access reads the restored objects anyway
+		if (g_needsLoad || g_loading) {
+			return;
+		}
+
+		switch (elemEvent.notifID) {
+			case APINotifyElement_Undo_Created:
+			case APINotifyElement_Undo_Modified:
+			case APINotifyElement_Undo_Deleted:
+			case APINotifyElement_Redo_Created:
+			case APINotifyElement_Redo_Modified:
+			case APINotifyElement_Redo_Deleted:
+				// Undo / redo restored the stored objects with the elements; one reload once the step is done
+				// Only steps that touched our elements - SpatialIndex observes every element on the story
+				if (!g_reloadScheduled && AffectsStoredState (elemEvent.elemHead.guid)) {
+					g_reloadScheduled = true;
+					EventLoop::Schedule (ReloadAfterUndo);
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	void Invalidate ()
+	{
+		ReloadAndReport ();
+	}
+
+} // namespace TrackingStore
@@ -0,0 +1,62 @@
+// *****************************************************************************
+// Header file for TrackingStore module (tracking maps persisted in the project)
+// *****************************************************************************
+
+#ifndef TRACKINGSTORE_HPP
+#define TRACKINGSTORE_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+// -----------------------------------------------------------------------------
+// HotspotManager, DimensionManager and DimensionSets live in process memory.
+// Their content (rhinoPointGuid -> hotspot, hotspot nodes -> dimension, named
+// sets) is stored in the project in a compact binary encoding, so a reopened
+// project reconnects to the existing elements instead of recreating them.
+//
+// The records are split into buckets of about two thousand, one add-on object
+// each; new items fill the newest bucket. Changes mark the record of the item,
+// and a save rewrites only the buckets holding marked records, so one added
+// dimension costs one bucket, not the whole tracked state.
+//
+// Loading is lazy: a project open only marks the maps as not loaded, the first
+// manager access decodes the objects. Saving happens at the end of the outermost
+// UndoSession::RunUndoable when the maps changed, so the stored state is part
+// of the same undo step as the element changes that caused it. Undo and redo
+// restore the stored objects together with the elements, so a step touching a
+// tracked element reloads the maps; ChangeFeed gets only the elements the
+// reload started or stopped tracking.
+// -----------------------------------------------------------------------------
+
+namespace TrackingStore {
+
+	// Decode the stored maps of the current project, once per project
+	void		EnsureLoaded ();
+
+	// The record of the item changed; written by the next SaveInUndoScope
+	void		MarkHotspotDirty (const API_Guid& hotspotGuid);
+	void		MarkDimensionDirty (const API_Guid& dimensionGuid);
+	void		MarkSetDirty (const GS::UniString& setId);
+
+	// Every stored record may have changed (the maps were cleared)
+	void		MarkAllDirty ();
+
+	// True while changes wait for SaveInUndoScope
+	bool		HasUnsavedChanges ();
+
+	// Write the changed buckets - must be called inside an open undo scope
+	GSErrCode	SaveInUndoScope ();
+
+	// Reload the maps from the project and report the difference to ChangeFeed
+	void		Invalidate ();
+
+	// Forward project events (APINotify_*) - drops the maps of the previous project
+	// Must run before the other modules see the event
+	void		OnProjectEvent (API_NotifyEventID notifID);
+
+	// Forward element notifications - undo / redo of a tracked element schedules a reload
+	void		OnElementEvent (const API_NotifyElementType& elemEvent);
+
+} // namespace TrackingStore
+
+#endif // TRACKINGSTORE_HPP
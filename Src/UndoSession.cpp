@@ -0,0 +1,179 @@
+// *****************************************************************************
+// Source code for UndoSession module (one undo step for many requests)
+// *****************************************************************************
+
+#include "UndoSession.hpp"
+#include "TrackingStore.hpp"
+#include <chrono>
+#include <utility>
+
+namespace UndoSession {
+
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		constexpr UInt32 MaxQueuedCommands = 100000;
+
+		struct QueuedCommand {
+			const API_AddOnCommand*	command = nullptr;		// owned by Archicad, lives as long as the add-on
+			GS::ObjectState			parameters;
+		};
+
+		GS::Array<QueuedCommand>	g_queue;
+		bool						g_recording = false;
+		bool						g_expired = false;		// the last session was dropped by the timeout
+		Clock::time_point			g_lastActivity;			// Begin or the last Enqueue
+		bool						g_inUndoScope = false;
+	}
+
+	GSErrCode RunUndoable (const GS::UniString& undoString, const std::function<GSErrCode ()>& body)
+	{
+		if (g_inUndoScope) {
+			return body ();
+		}
+
+		g_inUndoScope = true;
+		GSErrCode err = ACAPI_CallUndoableCommand (undoString, [&]() -> GSErrCode {
+			GSErrCode bodyErr = body ();
+			if (bodyErr == NoError) {
+				// Stored tracking maps change in the same undo step as the elements
+				bodyErr = TrackingStore::SaveInUndoScope ();
+			}
+			return bodyErr;
+		});
+		g_inUndoScope = false;
+		if (err != NoError && TrackingStore::HasUnsavedChanges ()) {
+			// The step is rolled back; the maps must follow the project, not the failed step
+			TrackingStore::Invalidate ();
+		}
+		return err;
+	}
+
+	GSErrCode RunNotUndoable (const GS::UniString& commandName, const std::function<GSErrCode ()>& body)
+	{
+		if (g_inUndoScope) {
+			return body ();
+		}
+
+		g_inUndoScope = true;
+		GSErrCode err = ACAPI_CallCommand (commandName, body);
+		g_inUndoScope = false;
+		return err;
+	}
+
+	void Begin ()
+	{
+		g_queue.Clear ();
+		g_recording = true;
+		g_expired = false;
+		g_lastActivity = Clock::now ();
+	}
+
+	bool IsRecording ()
+	{
+		if (g_recording && Clock::now () - g_lastActivity > std::chrono::milliseconds (SessionTimeoutMs)) {
+			// The client went away without committing - stop holding back every other request
+			Discard ();
+			g_expired = true;
+		}
+		return g_recording;
+	}
+
+	GS::ObjectState Enqueue (const API_AddOnCommand& command, const GS::ObjectState& parameters)
+	{
+		GS::ObjectState response;
+		if (g_queue.GetSize () >= MaxQueuedCommands) {
+			response.Add ("success", false);
+			GS::ObjectState errorOS;
+			errorOS.Add ("code", -10);
+			errorOS.Add ("message", "Session queue is full - commit the session first");
+			response.Add ("error", errorOS);
+			return response;
+		}
+
+		QueuedCommand queued;
+		queued.command = &command;
+		queued.parameters = parameters;
+		g_queue.Push (queued);
+		g_lastActivity = Clock::now ();
+
+		response.Add ("success", true);
+		response.Add ("queued", true);
+		response.Add ("queueIndex", (Int32)(g_queue.GetSize () - 1));
+		return response;
+	}
+
+	GS::ObjectState Commit (GS::ProcessControl& processControl)
+	{
+		if (!IsRecording () && g_expired) {
+			g_expired = false;
+			GS::ObjectState response;
+			response.Add ("success", false);
+			GS::ObjectState errorOS;
+			errorOS.Add ("code", -11);
+			errorOS.Add ("message", "Session expired - its queue was discarded");
+			response.Add ("error", errorOS);
+			return response;
+		}
+
+		// Replay executes the commands for real
+		g_recording = false;
+		GS::Array<QueuedCommand> queue = std::move (g_queue);
+		g_queue.Clear ();
+
+		GS::Array<GS::ObjectState> results;
+		results.SetCapacity (queue.GetSize ());
+		GSErrCode err = NoError;
+		if (!queue.IsEmpty ()) {
+			err = RunUndoable ("DimensionGh Session", [&]() -> GSErrCode {
+				for (const QueuedCommand& queued : queue) {
+					if (processControl.IsBreaked ()) {
+						break;
+					}
+					results.Push (queued.command->Execute (queued.parameters, processControl));
+				}
+				// Per-command failures are reported in results; keep what succeeded
+				return NoError;
+			});
+		}
+
+		GS::ObjectState response;
+		if (err != NoError) {
+			response.Add ("success", false);
+			GS::ObjectState errorOS;
+			errorOS.Add ("code", (Int32)err);
+			errorOS.Add ("message", "Failed to execute session in Archicad");
+			response.Add ("error", errorOS);
+			return response;
+		}
+
+		response.Add ("success", true);
+		response.Add ("executedCount", (Int32)results.GetSize ());
+		response.Add ("queuedCount", (Int32)queue.GetSize ());
+		response.Add ("results", results);
+		return response;
+	}
+
+	void Discard ()
+	{
+		g_queue.Clear ();
+		g_recording = false;
+	}
+
+	void OnProjectEvent (API_NotifyEventID notifID)
+	{
+		switch (notifID) {
+			case APINotify_New:
+			case APINotify_NewAndReset:
+			case APINotify_Open:
+			case APINotify_Close:
+			case APINotify_Quit:
+				Discard ();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+} // namespace UndoSession
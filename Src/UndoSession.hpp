@@ -0,0 +1,62 @@
+// *****************************************************************************
+// Header file for UndoSession module (one undo step for many requests)
+// *****************************************************************************
+
+#ifndef UNDOSESSION_HPP
+#define UNDOSESSION_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include <functional>
+
+// -----------------------------------------------------------------------------
+// Between BeginSession and CommitSession the modifying commands (CreateHotspot,
+// UpdateHotspot, DeleteHotspot, DeleteAllHotspots, UpsertHotspots,
+// TransformHotspots, CreateLinearDimension, CreateLinearDimensions,
+// CreateDimensionChain, SyncDimensionSet, DeleteDimensionSet, SweepHotspots)
+// do not touch the database: they queue their parameters and answer
+// "queued". CommitSession replays the queue inside a single
+// ACAPI_CallUndoableCommand, so one Grasshopper solve is one undo step.
+// A session that sees no request for SessionTimeoutMs is discarded, so a
+// client that dies after BeginSession does not hold back every later
+// request; committing it afterwards fails with code -11.
+//
+// Every undoable piece of work in the add-on goes through RunUndoable, which
+// joins the already open undo scope during replay instead of nesting
+// ACAPI_CallUndoableCommand (which is not allowed). The outermost scope also
+// writes the changed tracking maps (TrackingStore) before it closes.
+// -----------------------------------------------------------------------------
+
+namespace UndoSession {
+
+	// Idle time after which an uncommitted session is discarded
+	constexpr UInt32 SessionTimeoutMs = 60000;
+
+	// ACAPI_CallUndoableCommand, or just the body when an undo scope is already open
+	GSErrCode		RunUndoable (const GS::UniString& undoString, const std::function<GSErrCode ()>& body);
+
+	// ACAPI_CallCommand - changes without an undo step of their own (transient
+	// states such as live-drag frames); joins an already open undo scope
+	GSErrCode		RunNotUndoable (const GS::UniString& commandName, const std::function<GSErrCode ()>& body);
+
+	// Start queueing; an uncommitted previous session is discarded
+	void			Begin ();
+
+	// True while requests should be queued instead of executed; discards an expired session
+	bool			IsRecording ();
+
+	// Queue a command with its parameters; returns the "queued" response for the client
+	GS::ObjectState	Enqueue (const API_AddOnCommand& command, const GS::ObjectState& parameters);
+
+	// Replay the queue in one undo step; returns { success, executedCount, results: [ command responses ] }
+	GS::ObjectState	Commit (GS::ProcessControl& processControl);
+
+	// Drop the queue and stop recording
+	void			Discard ();
+
+	// Forward project events (APINotify_*) - a queue never outlives its project
+	void			OnProjectEvent (API_NotifyEventID notifID);
+
+} // namespace UndoSession
+
+#endif // UNDOSESSION_HPP
@@ -0,0 +1,87 @@
+// *****************************************************************************
+// JsonReader benchmark - parse time against payload size
+// *****************************************************************************
+
+// Builds CreateLinearDimensions-shaped requests of growing size (up to tens of
+// megabytes), parses each one several times and prints the best time and the
+// time per byte. The single-pass tokenizer is linear: ns/byte stays flat.
+//
+// Usage: JsonReaderBenchmark [maxPairs]   (default 256000 pairs, about 70 MB)
+
+#include "JsonReader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+	std::string MakeRequest (std::uint32_t pairCount)
+	{
+		std::string json = "{\"command\":\"CreateLinearDimensions\",\"payload\":{\"pairs\":[";
+		char buffer[512];
+		for (std::uint32_t i = 0; i < pairCount; ++i) {
+			const double x = i * 0.125 + 1.0 / 3.0;
+			const double y = -(i * 0.25) + 2.0 / 7.0;
+			snprintf (buffer, sizeof (buffer),
+					  "%s{\"point1\":{\"x\":%.17g,\"y\":%.17g,\"z\":0},\"point2\":{\"x\":%.17g,\"y\":%.17g,\"z\":0},"
+					  "\"rhinoPointGuid1\":\"%08x-0000-4000-8000-000000000001\",\"rhinoPointGuid2\":\"%08x-0000-4000-8000-000000000002\","
+					  "\"offset\":%.17g}",
+					  i == 0 ? "" : ",", x, y, x + 1.5, y - 0.75, i, i, 0.5 + i * 1e-3);
+			json += buffer;
+		}
+		json += "]}}";
+		return json;
+	}
+
+	// Parse and walk every pair (what the bridge does), best of repeatCount runs
+	double TimeParse (const std::string& json, int repeatCount, std::uint32_t& pairCount)
+	{
+		double best = 1e300;
+		for (int run = 0; run < repeatCount; ++run) {
+			const auto start = std::chrono::steady_clock::now ();
+
+			JsonReader::Document doc;
+			if (!doc.Parse (json)) {
+				fprintf (stderr, "parse failed at %zu: %s\n", doc.GetErrorOffset (), doc.GetErrorMessage ());
+				exit (1);
+			}
+			double sum = 0.0;
+			pairCount = 0;
+			const JsonReader::Value pairs = doc.GetRoot ().Find ("payload").Find ("pairs");
+			for (JsonReader::Value pair = pairs.First (); pair.IsValid (); pair = pair.Next ()) {
+				double x = 0.0;
+				pair.Find ("point1").Find ("x").GetDouble (x);
+				sum += x;
+				++pairCount;
+			}
+
+			const auto stop = std::chrono::steady_clock::now ();
+			best = std::min (best, std::chrono::duration<double, std::milli> (stop - start).count ());
+			if (sum == 0.123456789) {
+				printf (" ");		// keeps the walk from being optimized away
+			}
+		}
+		return best;
+	}
+
+}
+
+int main (int argc, char** argv)
+{
+	const std::uint32_t maxPairs = (argc > 1) ? (std::uint32_t)strtoul (argv[1], nullptr, 10) : 256000;
+
+	printf ("%10s %12s %12s %10s\n", "pairs", "bytes", "best ms", "ns/byte");
+	for (std::uint32_t pairCount = 1000; pairCount <= maxPairs; pairCount *= 2) {
+		const std::string json = MakeRequest (pairCount);
+		std::uint32_t walked = 0;
+		const double ms = TimeParse (json, pairCount <= 50000 ? 10 : 3, walked);
+		if (walked != pairCount) {
+			fprintf (stderr, "walked %u pairs instead of %u\n", walked, pairCount);
+			return 1;
+		}
+		printf ("%10u %12zu %12.3f %10.3f\n", pairCount, json.size (), ms, ms * 1e6 / (double)json.size ());
+	}
+	return 0;
+}
@@ -0,0 +1,208 @@
+// *****************************************************************************
+// JsonReader test - well-formed and malformed input, escapes, nesting
+// *****************************************************************************
+
+// Checks what the bridge relies on: malformed requests are rejected with an
+// offset, string escapes (including surrogate pairs) decode to UTF-8,
+// anything after the root value is an error, and deep nesting neither
+// recurses nor loses its structure.
+//
+// Usage: JsonReaderTest   (exit code 0 on success)
+
+#include "JsonReader.hpp"
+#include <cstdio>
+#include <string>
+
+namespace {
+
+	int g_failures = 0;
+	int g_checks = 0;
+
+	void Expect (bool condition, const char* what, int line)
+	{
+		++g_checks;
+		if (!condition) {
+			std::printf ("FAIL line %d: %s\n", line, what);
+			++g_failures;
+		}
+	}
+
+	#define EXPECT(condition) Expect ((condition), #condition, __LINE__)
+
+	bool Parses (const std::string& json)
+	{
+		JsonReader::Document doc;
+		return doc.Parse (json);
+	}
+
+	// Parse a one-string document and decode it
+	bool DecodeString (const std::string& json, std::string& out)
+	{
+		JsonReader::Document doc;
+		return doc.Parse (json) && doc.GetRoot ().GetString (out);
+	}
+
+	void TestWellFormed ()
+	{
+		JsonReader::Document doc;
+		EXPECT (doc.Parse ("{\"a\":1,\"b\":[true,false,null],\"c\":{\"d\":\"e\"},\"f\":-2.5e3}"));
+		const JsonReader::Value root = doc.GetRoot ();
+		EXPECT (root.IsObject ());
+		EXPECT (root.GetSize () == 4);
+
+		double a = 0.0;
+		EXPECT (root["a"].GetDouble (a) && a == 1.0);
+		double f = 0.0;
+		EXPECT (root["f"].GetDouble (f) && f == -2500.0);
+
+		const JsonReader::Value b = root["b"];
+		EXPECT (b.IsArray () && b.GetSize () == 3);
+		bool flag = false;
+		EXPECT (b.First ().GetBool (flag) && flag);
+		EXPECT (b.First ().Next ().GetBool (flag) && !flag);
+		EXPECT (b.First ().Next ().Next ().IsNull ());
+		EXPECT (!b.First ().Next ().Next ().Next ().IsValid ());
+
+		std::string d;
+		EXPECT (root["c"]["d"].GetString (d) && d == "e");
+		EXPECT (!root["missing"].IsValid ());
+		EXPECT (!root["a"]["x"].IsValid ());
+
+		EXPECT (Parses ("  [ ]  "));
+		EXPECT (Parses ("{}"));
+		EXPECT (Parses ("\"\""));
+		EXPECT (Parses ("0"));
+		EXPECT (Parses ("\t\r\n[1]\n"));
+	}
+
+	void TestMalformed ()
+	{
+		const char* cases[] = {
+			"",
+			"   ",
+			"{",
+			"[1,2",
+			"{\"a\":1,}",
+			"[1,]",
+			"[,1]",
+			"{\"a\" 1}",
+			"{a:1}",
+			"{\"a\":}",
+			"[1 2]",
+			"{\"a\":1]",
+			"[1}",
+			"\"unterminated",
+			"\"control\x01char\"",
+			"tru",
+			"nul",
+			"falsey",
+			"01",
+			"1.",
+			".5",
+			"1e",
+			"-",
+			"+1",
+			"[1]]",
+		};
+		for (const char* json : cases) {
+			JsonReader::Document doc;
+			const bool parsed = doc.Parse (json);
+			if (parsed) {
+				std::printf ("FAIL: accepted malformed input '%s'\n", json);
+				++g_failures;
+			} else if (doc.GetErrorMessage () == nullptr) {
+				std::printf ("FAIL: no error message for '%s'\n", json);
+				++g_failures;
+			}
+			++g_checks;
+		}
+
+		JsonReader::Document doc;
+		EXPECT (!doc.Parse ("{\"a\":1,,}"));
+		EXPECT (doc.GetErrorOffset () == 7);
+	}
+
+	void TestTrailingData ()
+	{
+		EXPECT (!Parses ("{} {}"));
+		EXPECT (!Parses ("[1] x"));
+		EXPECT (!Parses ("1 2"));
+		EXPECT (!Parses ("\"a\"\"b\""));
+		EXPECT (Parses ("{}   \n"));
+
+		JsonReader::Document doc;
+		EXPECT (!doc.Parse ("{}  }"));
+		EXPECT (doc.GetErrorOffset () == 4);
+	}
+
+	void TestEscapes ()
+	{
+		std::string out;
+		EXPECT (DecodeString ("\"a\\\"b\\\\c\\/d\"", out) && out == "a\"b\\c/d");
+		EXPECT (DecodeString ("\"\\b\\f\\n\\r\\t\"", out) && out == "\b\f\n\r\t");
+		EXPECT (DecodeString ("\"\\u0041\\u00e9\\u20AC\"", out) && out == "A\xC3\xA9\xE2\x82\xAC");
+		EXPECT (DecodeString ("\"caf\xC3\xA9\"", out) && out == "caf\xC3\xA9");		// raw UTF-8 passes through
+
+		// Surrogate pairs: U+1F600 and U+10FFFF
+		EXPECT (DecodeString ("\"\\uD83D\\uDE00\"", out) && out == "\xF0\x9F\x98\x80");
+		EXPECT (DecodeString ("\"\\uDBFF\\uDFFF\"", out) && out == "\xF4\x8F\xBF\xBF");
+		// Lone surrogates become U+FFFD
+		EXPECT (DecodeString ("\"\\uD83Dx\"", out) && out == "\xEF\xBF\xBDx");
+		EXPECT (DecodeString ("\"\\uDE00\"", out) && out == "\xEF\xBF\xBD");
+		EXPECT (DecodeString ("\"\\uD83D\\u0041\"", out) && out == "\xEF\xBF\xBD" "A");
+
+		// Invalid escapes are rejected when the string is read
+		EXPECT (!DecodeString ("\"\\x\"", out));
+		EXPECT (!DecodeString ("\"\\u12\"", out));
+		EXPECT (!DecodeString ("\"\\u12G4\"", out));
+
+		// Escaped quote does not end the string; escaped keys are found by their decoded name
+		JsonReader::Document doc;
+		EXPECT (doc.Parse ("{\"k\\u0065y\":\"v\\\"\"}"));
+		EXPECT (doc.GetRoot ()["key"].GetString (out) && out == "v\"");
+		EXPECT (doc.GetRoot ().First ().GetKey () == "key");
+	}
+
+	void TestDeepNesting ()
+	{
+		// The parser keeps its own stack - no recursion, so depth is only bounded by memory
+		const int depth = 100000;
+		std::string json (depth, '[');
+		json += "1";
+		json += std::string (depth, ']');
+
+		JsonReader::Document doc;
+		EXPECT (doc.Parse (json));
+		JsonReader::Value value = doc.GetRoot ();
+		int levels = 0;
+		while (value.IsArray ()) {
+			value = value.First ();
+			++levels;
+		}
+		double one = 0.0;
+		EXPECT (levels == depth);
+		EXPECT (value.GetDouble (one) && one == 1.0);
+
+		std::string unbalanced (depth, '{');
+		EXPECT (!Parses (unbalanced));
+		std::string missingClose (depth, '[');
+		missingClose += std::string (depth - 1, ']');
+		EXPECT (!Parses (missingClose));
+	}
+}
+
+int main ()
+{
+	TestWellFormed ();
+	TestMalformed ();
+	TestTrailingData ();
+	TestEscapes ();
+	TestDeepNesting ();
+
+	if (g_failures != 0) {
+		std::printf ("JsonReaderTest: %d of %d checks failed\n", g_failures, g_checks);
+		return 1;
+	}
+	std::printf ("JsonReaderTest: %d checks passed\n", g_checks);
+	return 0;
+}
@@ -0,0 +1,102 @@
+// *****************************************************************************
+// NumberParser benchmark - ParseDouble against the old substring + atof path
+// *****************************************************************************
+
+// Formats random doubles with %.17g into one buffer and parses all of them
+// with NumberParser::ParseDouble and with the path the bridge used before
+// (copy the token into a string, then atof), and checks that both agree.
+// Correctness against strtod is covered by NumberParserTest.
+//
+// Usage: NumberParserBenchmark [count]   (default 1000000)
+
+#include "NumberParser.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+	struct Token {
+		std::size_t	begin = 0;
+		std::size_t	end = 0;
+	};
+
+	bool SameBits (double a, double b)
+	{
+		return std::memcmp (&a, &b, sizeof (double)) == 0;
+	}
+
+	template <typename Parse>
+	double TimeBest (int repeatCount, const Parse& parse)
+	{
+		double best = 1e300;
+		for (int run = 0; run < repeatCount; ++run) {
+			const auto start = std::chrono::steady_clock::now ();
+			parse ();
+			const auto stop = std::chrono::steady_clock::now ();
+			best = std::min (best, std::chrono::duration<double, std::milli> (stop - start).count ());
+		}
+		return best;
+	}
+
+}
+
+int main (int argc, char** argv)
+{
+	const std::size_t count = (argc > 1) ? (std::size_t)strtoull (argv[1], nullptr, 10) : 1000000;
+
+	// Coordinates in model units plus a spread of magnitudes
+	std::mt19937_64 random (42);
+	std::uniform_real_distribution<double> coordinate (-1e5, 1e5);
+	std::uniform_int_distribution<int> magnitude (-30, 30);
+	std::string text;
+	std::vector<Token> tokens;
+	tokens.reserve (count);
+	char buffer[64];
+	for (std::size_t i = 0; i < count; ++i) {
+		double value = coordinate (random);
+		if (i % 4 == 3) {
+			value *= std::pow (10.0, magnitude (random));
+		}
+		const int length = snprintf (buffer, sizeof (buffer), "%.17g", value);
+		Token token;
+		token.begin = text.size ();
+		text.append (buffer, (std::size_t)length);
+		token.end = text.size ();
+		tokens.push_back (token);
+		text += ',';
+	}
+
+	std::vector<double> fast (count);
+	std::vector<double> old (count);
+
+	const double fastMs = TimeBest (5, [&] () {
+		for (std::size_t i = 0; i < count; ++i) {
+			NumberParser::ParseDouble (text.data () + tokens[i].begin, text.data () + tokens[i].end, fast[i]);
+		}
+	});
+	const double oldMs = TimeBest (5, [&] () {
+		for (std::size_t i = 0; i < count; ++i) {
+			const std::string token = text.substr (tokens[i].begin, tokens[i].end - tokens[i].begin);
+			old[i] = std::atof (token.c_str ());
+		}
+	});
+
+	for (std::size_t i = 0; i < count; ++i) {
+		if (!SameBits (fast[i], old[i])) {
+			fprintf (stderr, "mismatch at %zu: %.17g vs %.17g\n", i, fast[i], old[i]);
+			return 1;
+		}
+	}
+
+	printf ("%zu doubles (%zu bytes)\n", count, text.size ());
+	printf ("  ParseDouble       %10.3f ms  %7.1f ns/number\n", fastMs, fastMs * 1e6 / (double)count);
+	printf ("  substring + atof  %10.3f ms  %7.1f ns/number\n", oldMs, oldMs * 1e6 / (double)count);
+	return 0;
+}
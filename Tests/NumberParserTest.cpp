@@ -0,0 +1,155 @@
+// *****************************************************************************
+// NumberParser test - ParseDouble against strtod, bit for bit
+// *****************************************************************************
+
+// Every result of NumberParser::ParseDouble must equal strtod's: inputs that
+// miss the fast paths (subnormals, overflow, halfway cases, long mantissas),
+// random doubles printed with 17 and with fewer significant digits, and
+// random bit patterns. Malformed numbers must be rejected.
+//
+// Usage: NumberParserTest   (exit code 0 on success)
+
+#include "NumberParser.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace {
+
+	bool SameBits (double a, double b)
+	{
+		return std::memcmp (&a, &b, sizeof (double)) == 0;
+	}
+
+	// Whole text must parse to what strtod gives
+	int CheckOne (const std::string& text)
+	{
+		double parsed = 0.0;
+		const char* last = text.data () + text.size ();
+		const char* end = NumberParser::ParseDouble (text.data (), last, parsed);
+		const double expected = std::strtod (text.c_str (), nullptr);
+		if (end != last || !SameBits (parsed, expected)) {
+			std::printf ("FAIL %s -> %.17g, strtod %.17g\n", text.c_str (), parsed, expected);
+			return 1;
+		}
+		return 0;
+	}
+
+	// Inputs that miss the fast paths
+	int CheckHardCases ()
+	{
+		const char* cases[] = {
+			"0",
+			"-0",
+			"2.2250738585072011e-308",			// largest subnormal
+			"2.2250738585072014e-308",			// smallest normal
+			"4.9406564584124654e-324",			// smallest subnormal
+			"2.4703282292062327e-324",			// below half of it - rounds to 0
+			"2.4703282292062328e-324",			// above half of it - rounds up
+			"1e-400",
+			"1.7976931348623157e308",
+			"1.7976931348623159e308",			// rounds to infinity
+			"1e400",
+			"9007199254740993",					// 2^53 + 1, halfway
+			"9007199254740993.0000000000000000000000000000001",
+			"9007199254740995",					// halfway, rounds to even upward
+			"0.1000000000000000055511151231257827021181583404541015625",
+			"0.10000000000000000555111512312578270211815834045410156250000000000000001",
+			"-123456789012345678901234567890.123456789e-10",
+			"0.000000000000000000000000000000000000000000000000000000000000123456789012345678901234567890",
+			"1e22",
+			"1e23",								// first power of ten that is not exact
+			"123456789012345678e-5",
+			"1E+2",
+			"1e-0"
+		};
+
+		int failures = 0;
+		for (const char* text : cases) {
+			failures += CheckOne (text);
+		}
+
+		// 1000-digit mantissa: exercises the sticky digit of the slow path
+		std::string longText = "1.";
+		for (int i = 0; i < 1000; ++i) {
+			longText += (i == 999) ? '1' : '0';
+		}
+		longText += "e-300";
+		failures += CheckOne (longText);
+		return failures;
+	}
+
+	int CheckMalformed ()
+	{
+		const char* cases[] = { "", "-", "+1", ".5", "1.", "1e", "1e+", "-.5", "e5", "x" };
+
+		int failures = 0;
+		for (const char* text : cases) {
+			double parsed = 0.0;
+			if (NumberParser::ParseDouble (text, text + std::strlen (text), parsed) != nullptr) {
+				std::printf ("FAIL accepted malformed number '%s'\n", text);
+				++failures;
+			}
+		}
+
+		// Stops after the number: the rest belongs to the JSON around it
+		const char* text = "12.5,";
+		double parsed = 0.0;
+		if (NumberParser::ParseDouble (text, text + 5, parsed) != text + 4 || parsed != 12.5) {
+			std::printf ("FAIL '12.5,' did not stop at the comma\n");
+			++failures;
+		}
+		return failures;
+	}
+
+	int CheckRandom (std::size_t count)
+	{
+		std::mt19937_64 random (42);
+		std::uniform_real_distribution<double> coordinate (-1e5, 1e5);
+		std::uniform_int_distribution<int> magnitude (-30, 30);
+		std::uniform_int_distribution<int> precision (1, 17);
+
+		int failures = 0;
+		char buffer[64];
+		for (std::size_t i = 0; i < count && failures < 10; ++i) {
+			// Coordinates in model units plus a spread of magnitudes
+			double value = coordinate (random);
+			if (i % 4 == 3) {
+				value *= std::pow (10.0, magnitude (random));
+			}
+			std::snprintf (buffer, sizeof (buffer), "%.17g", value);
+			failures += CheckOne (buffer);
+			std::snprintf (buffer, sizeof (buffer), "%.*g", precision (random), value);
+			failures += CheckOne (buffer);
+
+			// Any finite double
+			const std::uint64_t bits = random ();
+			double any = 0.0;
+			std::memcpy (&any, &bits, sizeof (double));
+			if (std::isfinite (any)) {
+				std::snprintf (buffer, sizeof (buffer), "%.17g", any);
+				failures += CheckOne (buffer);
+			}
+		}
+		return failures;
+	}
+}
+
+int main ()
+{
+	int failures = 0;
+	failures += CheckHardCases ();
+	failures += CheckMalformed ();
+	failures += CheckRandom (200000);
+
+	if (failures != 0) {
+		std::printf ("NumberParserTest: %d failure(s)\n", failures);
+		return 1;
+	}
+	std::printf ("NumberParserTest: passed\n");
+	return 0;
+}
@@ -0,0 +1,202 @@
+// *****************************************************************************
+// PlacementKernel test - SIMD lanes against a scalar reference
+// *****************************************************************************
+
+// Runs ComputePlacements on random pairs and on edge cases (coincident and
+// nearly coincident points, tiny and NaN offsets, NaN and infinite
+// coordinates) for every count up to a few SIMD widths, so both the vector
+// lanes and the scalar tail are covered. Every output must match, bit for
+// bit, a plain scalar implementation of the documented formulas - which
+// only holds when no path fuses a multiply-add (see Tests/CMakeLists.txt).
+//
+// Usage: PlacementKernelTest   (exit code 0 on success)
+
+#include "PlacementKernel.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+	struct Pairs {
+		std::vector<double>	x1, y1, x2, y2, offset;
+
+		void Add (double ax, double ay, double bx, double by, double off)
+		{
+			x1.push_back (ax);
+			y1.push_back (ay);
+			x2.push_back (bx);
+			y2.push_back (by);
+			offset.push_back (off);
+		}
+
+		size_t Size () const { return x1.size (); }
+	};
+
+	struct Placements {
+		std::vector<double>			dirX, dirY, perpX, perpY, refX, refY, length;
+		std::vector<unsigned char>	degenerate;
+
+		explicit Placements (size_t count) :
+			dirX (count), dirY (count), perpX (count), perpY (count), refX (count), refY (count), length (count), degenerate (count)
+		{
+		}
+	};
+
+	// The formulas of PlacementKernel.hpp, one pair at a time
+	void ComputeReference (const Pairs& in, Placements& out, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i) {
+			const double dx = in.x2[i] - in.x1[i];
+			const double dy = in.y2[i] - in.y1[i];
+			const double len = std::sqrt (dx * dx + dy * dy);
+			const bool degenerate = !(len >= PlacementKernel::MinLength);
+			const double invLen = degenerate ? 0.0 : 1.0 / len;
+			const double px = -dy * invLen;
+			const double py = dx * invLen;
+			const double offset = (std::abs (in.offset[i]) > PlacementKernel::MinOffset) ? in.offset[i] : 0.0;
+
+			out.dirX[i] = dx;
+			out.dirY[i] = dy;
+			out.perpX[i] = px;
+			out.perpY[i] = py;
+			out.refX[i] = in.x1[i] + px * offset;
+			out.refY[i] = in.y1[i] + py * offset;
+			out.length[i] = len;
+			out.degenerate[i] = degenerate ? 1 : 0;
+		}
+	}
+
+	// Bitwise, except that any NaN matches any NaN (the sign of a NaN is not specified)
+	bool Same (double a, double b)
+	{
+		if (std::isnan (a) || std::isnan (b)) {
+			return std::isnan (a) && std::isnan (b);
+		}
+		return std::memcmp (&a, &b, sizeof (double)) == 0;
+	}
+
+	int Compare (const char* name, const std::vector<double>& actual, const std::vector<double>& expected, size_t count, size_t caseIndex)
+	{
+		for (size_t i = 0; i < count; ++i) {
+			if (!Same (actual[i], expected[i])) {
+				std::printf ("FAIL case %zu, %s[%zu]: %.17g, expected %.17g\n", caseIndex, name, i, actual[i], expected[i]);
+				return 1;
+			}
+		}
+		return 0;
+	}
+
+	int Check (const Pairs& pairs, size_t count, size_t caseIndex)
+	{
+		Placements actual (count);
+		Placements expected (count);
+
+		PlacementKernel::LineInputs in;
+		in.x1 = pairs.x1.data ();
+		in.y1 = pairs.y1.data ();
+		in.x2 = pairs.x2.data ();
+		in.y2 = pairs.y2.data ();
+		in.offset = pairs.offset.data ();
+
+		PlacementKernel::LinePlacements out;
+		out.dirX = actual.dirX.data ();
+		out.dirY = actual.dirY.data ();
+		out.perpX = actual.perpX.data ();
+		out.perpY = actual.perpY.data ();
+		out.refX = actual.refX.data ();
+		out.refY = actual.refY.data ();
+		out.length = actual.length.data ();
+		out.degenerate = actual.degenerate.data ();
+
+		PlacementKernel::ComputePlacements (in, out, count);
+		ComputeReference (pairs, expected, count);
+
+		int failures = 0;
+		failures += Compare ("dirX", actual.dirX, expected.dirX, count, caseIndex);
+		failures += Compare ("dirY", actual.dirY, expected.dirY, count, caseIndex);
+		failures += Compare ("perpX", actual.perpX, expected.perpX, count, caseIndex);
+		failures += Compare ("perpY", actual.perpY, expected.perpY, count, caseIndex);
+		failures += Compare ("refX", actual.refX, expected.refX, count, caseIndex);
+		failures += Compare ("refY", actual.refY, expected.refY, count, caseIndex);
+		failures += Compare ("length", actual.length, expected.length, count, caseIndex);
+		for (size_t i = 0; i < count; ++i) {
+			if (actual.degenerate[i] != expected.degenerate[i]) {
+				std::printf ("FAIL case %zu, degenerate[%zu]: %d, expected %d\n", caseIndex, i, actual.degenerate[i], expected.degenerate[i]);
+				++failures;
+				break;
+			}
+		}
+		return failures;
+	}
+
+	Pairs MakeEdgeCases ()
+	{
+		const double nan = std::numeric_limits<double>::quiet_NaN ();
+		const double inf = std::numeric_limits<double>::infinity ();
+		const double tiny = PlacementKernel::MinLength;
+
+		Pairs pairs;
+		pairs.Add (0.0, 0.0, 1.0, 0.0, 0.5);				// plain horizontal
+		pairs.Add (1.0, 2.0, 1.0, 2.0, 0.5);				// coincident points
+		pairs.Add (0.0, 0.0, tiny * 0.5, 0.0, 0.5);			// just below MinLength
+		pairs.Add (0.0, 0.0, tiny, 0.0, 0.5);				// exactly MinLength
+		pairs.Add (-3.0, 4.0, 0.0, 0.0, -2.0);				// negative offset
+		pairs.Add (0.0, 0.0, 0.0, 5.0, tiny * 0.5);			// offset below MinOffset
+		pairs.Add (0.0, 0.0, 0.0, 5.0, -tiny * 0.5);
+		pairs.Add (0.0, 0.0, 3.0, 4.0, nan);				// NaN offset - treated as none
+		pairs.Add (nan, 0.0, 1.0, 1.0, 1.0);				// NaN coordinate - degenerate
+		pairs.Add (0.0, 0.0, inf, 1.0, 1.0);				// infinite length
+		pairs.Add (0.0, 0.0, -0.0, 2.0, 1.0);				// signed zeros
+		pairs.Add (1e300, 1e300, -1e300, -1e300, 1.0);		// dx * dx overflows
+		pairs.Add (1e-200, 0.0, 2e-200, 0.0, 1.0);			// dx * dx underflows
+		return pairs;
+	}
+
+	Pairs MakeRandomPairs (size_t count)
+	{
+		std::mt19937_64 random (12345);
+		std::uniform_real_distribution<double> coord (-1.0e4, 1.0e4);
+		std::uniform_real_distribution<double> offset (-5.0, 5.0);
+
+		Pairs pairs;
+		for (size_t i = 0; i < count; ++i) {
+			pairs.Add (coord (random), coord (random), coord (random), coord (random), offset (random));
+		}
+		return pairs;
+	}
+}
+
+int main ()
+{
+	int failures = 0;
+	size_t caseIndex = 0;
+
+	// Every count from 0 on, so each edge case lands in a vector lane and in the scalar tail
+	const Pairs edgeCases = MakeEdgeCases ();
+	for (size_t rotation = 0; rotation < edgeCases.Size (); ++rotation) {
+		Pairs rotated;
+		for (size_t i = 0; i < edgeCases.Size (); ++i) {
+			const size_t j = (i + rotation) % edgeCases.Size ();
+			rotated.Add (edgeCases.x1[j], edgeCases.y1[j], edgeCases.x2[j], edgeCases.y2[j], edgeCases.offset[j]);
+		}
+		for (size_t count = 0; count <= rotated.Size (); ++count) {
+			failures += Check (rotated, count, caseIndex++);
+		}
+	}
+
+	const Pairs randomPairs = MakeRandomPairs (10007);
+	for (size_t count : { (size_t)1, (size_t)2, (size_t)3, (size_t)4, (size_t)5, (size_t)7, (size_t)8, (size_t)9, randomPairs.Size () }) {
+		failures += Check (randomPairs, count, caseIndex++);
+	}
+
+	if (failures != 0) {
+		std::printf ("PlacementKernelTest: %d failure(s)\n", failures);
+		return 1;
+	}
+	std::printf ("PlacementKernelTest: %zu cases passed\n", caseIndex);
+	return 0;
+}